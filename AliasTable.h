@@ -0,0 +1,105 @@
+/**
+ * @file AliasTable.h
+ * @brief Walker alias table for constant time sampling of empirical discrete distributions
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef ALIASTABLE_H
+#define ALIASTABLE_H
+
+#include <array>
+#include <random>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Each of N columns holds probability of its own index and an alias index that takes the rest of the column.
+ * Sampling draws a column and a point in it, so it takes O(1) instead of O(log N) of std::discrete_distribution.
+ * Table is built by Vose's variant of the Walker method and can be built at compile time from constexpr weights.
+ * @tparam N number of weights
+ */
+template<size_t N>
+class AliasTable {
+	std::array<double, N> probability{};
+	std::array<uint32_t, N> alias{};
+
+public:
+	/**
+	 *
+	 * @param weights non-negative weights of indexes, at least one weight must be positive
+	 */
+	constexpr explicit AliasTable(const double (&weights)[N]) {
+		double sum = 0;
+		for (size_t i = 0; i < N; i++) {
+			sum += weights[i];
+		}
+
+		// Scale weights so that mean column is full
+		std::array<double, N> scaled{};
+		std::array<uint32_t, N> small{};
+		std::array<uint32_t, N> large{};
+		size_t smallCount = 0;
+		size_t largeCount = 0;
+
+		for (size_t i = 0; i < N; i++) {
+			scaled[i] = weights[i] * double(N) / sum;
+			if (scaled[i] < 1.0) {
+				small[smallCount++] = uint32_t(i);
+			}
+			else {
+				large[largeCount++] = uint32_t(i);
+			}
+		}
+
+		// Fill each underfull column with the rest of an overfull column
+		while (smallCount > 0 && largeCount > 0) {
+			uint32_t less = small[--smallCount];
+			uint32_t more = large[--largeCount];
+
+			probability[less] = scaled[less];
+			alias[less] = more;
+
+			scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+			if (scaled[more] < 1.0) {
+				small[smallCount++] = more;
+			}
+			else {
+				large[largeCount++] = more;
+			}
+		}
+
+		// Remaining columns are full up to floating point error
+		while (largeCount > 0) {
+			uint32_t column = large[--largeCount];
+			probability[column] = 1.0;
+			alias[column] = column;
+		}
+		while (smallCount > 0) {
+			uint32_t column = small[--smallCount];
+			probability[column] = 1.0;
+			alias[column] = column;
+		}
+	}
+
+	/**
+	 *
+	 * @param randomGen Random generator
+	 * @return Index drawn with probability proportional to its weight
+	 */
+	template<class Generator>
+	size_t operator()(Generator &randomGen) const {
+		std::uniform_real_distribution<> point(0.0, double(N));
+		double x = point(randomGen);
+
+		auto column = size_t(x);
+		if (column >= N) {
+			column = N - 1;
+		}
+
+		return x - double(column) < probability[column] ? column : alias[column];
+	}
+};
+
+#endif //ALIASTABLE_H
@@ -24,6 +24,39 @@ Simulation ArgParser::createSimulation(int argc, char *argv[]) {
 			{"init_tx_count",        required_argument, nullptr, OPT_INIT_TX_COUNT},
 			{"honest_random_remove", no_argument,       nullptr, OPT_HONEST_RAND_REMOVE},
 			{"mp_print_data",        no_argument,       nullptr, OPT_MP_PRINT_DATA},
+			{"tx_arrival",           required_argument, nullptr, OPT_TX_ARRIVAL},
+			{"tx_rate",              required_argument, nullptr, OPT_TX_RATE},
+			{"tx_batch_interval",    required_argument, nullptr, OPT_TX_BATCH_INTERVAL},
+			{"tx_burst_factor",      required_argument, nullptr, OPT_TX_BURST_FACTOR},
+			{"tx_burst_enter",       required_argument, nullptr, OPT_TX_BURST_ENTER},
+			{"tx_burst_exit",        required_argument, nullptr, OPT_TX_BURST_EXIT},
+			{"tx_diurnal_amplitude", required_argument, nullptr, OPT_TX_DIURNAL_AMPLITUDE},
+			{"tx_diurnal_period",    required_argument, nullptr, OPT_TX_DIURNAL_PERIOD},
+			{"tx_trace",             required_argument, nullptr, OPT_TX_TRACE},
+			{"tx_trace_time_scale",  required_argument, nullptr, OPT_TX_TRACE_TIME_SCALE},
+			{"tx_trace_loop",        no_argument,       nullptr, OPT_TX_TRACE_LOOP},
+			{"tx_gossip",            no_argument,       nullptr, OPT_TX_GOSSIP},
+			{"trickle_interval",     required_argument, nullptr, OPT_TRICKLE_INTERVAL},
+			{"lazy_mempool",         no_argument,       nullptr, OPT_LAZY_MEMPOOL},
+			{"propagation",          required_argument, nullptr, OPT_PROPAGATION},
+			{"matrix_resolution",    required_argument, nullptr, OPT_MATRIX_RESOLUTION},
+			{"bandwidth",            required_argument, nullptr, OPT_BANDWIDTH},
+			{"tx_vsize",             required_argument, nullptr, OPT_TX_VSIZE},
+			{"compact_blocks",       no_argument,       nullptr, OPT_COMPACT_BLOCKS},
+			{"block_relay",          required_argument, nullptr, OPT_BLOCK_RELAY},
+			{"topology",             required_argument, nullptr, OPT_TOPOLOGY},
+			{"reorder",              required_argument, nullptr, OPT_REORDER},
+			{"churn_rate",           required_argument, nullptr, OPT_CHURN_RATE},
+			{"churn_downtime",       required_argument, nullptr, OPT_CHURN_DOWNTIME},
+			{"link_failure_rate",    required_argument, nullptr, OPT_LINK_FAILURE_RATE},
+			{"link_downtime",        required_argument, nullptr, OPT_LINK_DOWNTIME},
+			{"coarsen",              required_argument, nullptr, OPT_COARSEN},
+			{"consensus",            required_argument, nullptr, OPT_CONSENSUS},
+			{"ghostdag_k",           required_argument, nullptr, OPT_GHOSTDAG_K},
+			{"no_data",              no_argument,       nullptr, OPT_NO_DATA},
+			{"validation_base",      required_argument, nullptr, OPT_VALIDATION_BASE},
+			{"validation_per_tx",    required_argument, nullptr, OPT_VALIDATION_PER_TX},
+			{"block_horizon",        required_argument, nullptr, OPT_BLOCK_HORIZON},
 			{nullptr,                no_argument,       nullptr, OPT_INVALID}
 	};
 
@@ -125,6 +158,274 @@ Simulation ArgParser::createSimulation(int argc, char *argv[]) {
 			case OPT_MP_PRINT_DATA:
 				simulation.mpPrintData = true;
 				break;
+			case OPT_TX_ARRIVAL:
+				if (std::string(optarg) == "uniform") {
+					simulation.txArrivalType = ARRIVAL_UNIFORM;
+				}
+				else if (std::string(optarg) == "poisson") {
+					simulation.txArrivalType = ARRIVAL_POISSON;
+				}
+				else if (std::string(optarg) == "bursty") {
+					simulation.txArrivalType = ARRIVAL_BURSTY;
+				}
+				else if (std::string(optarg) == "diurnal") {
+					simulation.txArrivalType = ARRIVAL_DIURNAL;
+				}
+				else if (std::string(optarg) == "trace") {
+					simulation.txArrivalType = ARRIVAL_TRACE;
+				}
+				else {
+					this->errorExit("Invalid transaction arrival process argument");
+				}
+				break;
+			case OPT_TX_RATE:
+				try {
+					simulation.txRate = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid transaction rate argument");
+				}
+				break;
+			case OPT_TX_BATCH_INTERVAL:
+				try {
+					simulation.txBatchInterval = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid transaction batch interval argument");
+				}
+				break;
+			case OPT_TX_BURST_FACTOR:
+				try {
+					simulation.txBurstFactor = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid transaction burst factor argument");
+				}
+				break;
+			case OPT_TX_BURST_ENTER:
+				try {
+					simulation.txBurstEnter = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid transaction burst enter probability argument");
+				}
+				break;
+			case OPT_TX_BURST_EXIT:
+				try {
+					simulation.txBurstExit = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid transaction burst exit probability argument");
+				}
+				break;
+			case OPT_TX_DIURNAL_AMPLITUDE:
+				try {
+					simulation.txDiurnalAmplitude = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid transaction diurnal amplitude argument");
+				}
+				break;
+			case OPT_TX_DIURNAL_PERIOD:
+				try {
+					simulation.txDiurnalPeriod = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid transaction diurnal period argument");
+				}
+				break;
+			case OPT_TX_TRACE:
+				simulation.txTracePath = optarg;
+				break;
+			case OPT_TX_TRACE_TIME_SCALE:
+				try {
+					simulation.txTraceTimeScale = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid transaction trace time scale argument");
+				}
+				break;
+			case OPT_TX_TRACE_LOOP:
+				simulation.txTraceLoop = true;
+				break;
+			case OPT_TX_GOSSIP:
+				simulation.txGossip = true;
+				break;
+			case OPT_LAZY_MEMPOOL:
+				simulation.lazyMempool = true;
+				break;
+			case OPT_PROPAGATION:
+				if (std::string(optarg) == "flood") {
+					simulation.propagationMode = PROPAGATION_FLOOD;
+				}
+				else if (std::string(optarg) == "shortest_path") {
+					simulation.propagationMode = PROPAGATION_SHORTEST_PATH;
+				}
+				else if (std::string(optarg) == "matrix") {
+					simulation.propagationMode = PROPAGATION_MATRIX;
+				}
+				else {
+					this->errorExit("Invalid block propagation argument");
+				}
+				break;
+			case OPT_MATRIX_RESOLUTION:
+				try {
+					simulation.matrixResolution = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid latency matrix resolution argument");
+				}
+				break;
+			case OPT_BANDWIDTH:
+				try {
+					simulation.bandwidth = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid bandwidth argument");
+				}
+				break;
+			case OPT_TX_VSIZE:
+				try {
+					simulation.txVsize = std::stoul(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid transaction size argument");
+				}
+				break;
+			case OPT_COMPACT_BLOCKS:
+				simulation.compactBlocks = true;
+				break;
+			case OPT_BLOCK_RELAY:
+				if (std::string(optarg) == "push") {
+					simulation.blockRelay = BLOCK_RELAY_PUSH;
+				}
+				else if (std::string(optarg) == "inv") {
+					simulation.blockRelay = BLOCK_RELAY_INV;
+				}
+				else {
+					this->errorExit("Invalid block relay argument");
+				}
+				break;
+			case OPT_TOPOLOGY:
+				if (std::string(optarg).rfind("gen:", 0) != 0) {
+					this->errorExit("Invalid topology argument; generated topology must start with gen:");
+				}
+				simulation.topologySpec = std::string(optarg).substr(4);
+				break;
+			case OPT_REORDER:
+				if (std::string(optarg) == "none") {
+					simulation.reorderMode = REORDER_NONE;
+				}
+				else if (std::string(optarg) == "bfs") {
+					simulation.reorderMode = REORDER_BFS;
+				}
+				else if (std::string(optarg) == "rcm") {
+					simulation.reorderMode = REORDER_RCM;
+				}
+				else if (std::string(optarg) == "community") {
+					simulation.reorderMode = REORDER_COMMUNITY;
+				}
+				else {
+					this->errorExit("Invalid reorder argument");
+				}
+				break;
+			case OPT_CHURN_RATE:
+				try {
+					simulation.churnRate = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid churn rate argument");
+				}
+				break;
+			case OPT_CHURN_DOWNTIME:
+				try {
+					simulation.churnDowntime = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid churn downtime argument");
+				}
+				break;
+			case OPT_LINK_FAILURE_RATE:
+				try {
+					simulation.linkFailureRate = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid link failure rate argument");
+				}
+				break;
+			case OPT_LINK_DOWNTIME:
+				try {
+					simulation.linkDowntime = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid link downtime argument");
+				}
+				break;
+			case OPT_COARSEN:
+				try {
+					simulation.coarsenThreshold = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid coarsen argument");
+				}
+				break;
+			case OPT_CONSENSUS:
+				if (std::string(optarg) == "depth") {
+					simulation.consensus = CONSENSUS_DEPTH;
+				}
+				else if (std::string(optarg) == "ghostdag") {
+					simulation.consensus = CONSENSUS_GHOSTDAG;
+				}
+				else if (std::string(optarg) == "spectre") {
+					simulation.consensus = CONSENSUS_SPECTRE;
+				}
+				else {
+					this->errorExit("Invalid consensus argument");
+				}
+				break;
+			case OPT_GHOSTDAG_K:
+				try {
+					simulation.ghostdagK = std::stoul(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid ghostdag k argument");
+				}
+				break;
+			case OPT_NO_DATA:
+				simulation.noData = true;
+				break;
+			case OPT_VALIDATION_BASE:
+				try {
+					simulation.validationBase = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid validation base argument");
+				}
+				break;
+			case OPT_VALIDATION_PER_TX:
+				try {
+					simulation.validationPerTx = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid validation per transaction argument");
+				}
+				break;
+			case OPT_BLOCK_HORIZON:
+				try {
+					simulation.blockHorizon = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid block horizon argument");
+				}
+				break;
+			case OPT_TRICKLE_INTERVAL:
+				try {
+					simulation.trickleInterval = std::stod(optarg);
+				}
+				catch (std::exception &e) {
+					this->errorExit("Invalid trickle interval argument");
+				}
+				break;
 			case OPT_HELP:
 				this->printHelp();
 				std::exit(EXIT_SUCCESS);
@@ -160,6 +461,91 @@ Simulation ArgParser::createSimulation(int argc, char *argv[]) {
 		this->errorExit("Invalid transaction generation time (min must be less or equal than max)");
 	}
 
+	if (simulation.txRate <= 0) {
+		this->errorExit("Invalid transaction rate; it must be greater than 0");
+	}
+
+	if (simulation.txBatchInterval <= 0) {
+		this->errorExit("Invalid transaction batch interval; it must be greater than 0");
+	}
+
+	if (simulation.txBurstFactor <= 0) {
+		this->errorExit("Invalid transaction burst factor; it must be greater than 0");
+	}
+
+	if (simulation.txBurstEnter < 0 || simulation.txBurstEnter > 1 || simulation.txBurstExit < 0 ||
+	    simulation.txBurstExit > 1) {
+		this->errorExit("Invalid transaction burst probability; it must be in interval <0, 1>");
+	}
+
+	if (simulation.txDiurnalAmplitude < 0 || simulation.txDiurnalAmplitude > 1) {
+		this->errorExit("Invalid transaction diurnal amplitude; it must be in interval <0, 1>");
+	}
+
+	if (simulation.txDiurnalPeriod <= 0) {
+		this->errorExit("Invalid transaction diurnal period; it must be greater than 0");
+	}
+
+	if (simulation.txArrivalType == ARRIVAL_TRACE && simulation.txTracePath.empty()) {
+		this->errorExit("Trace transaction arrival requires a trace file (--tx_trace)");
+	}
+
+	if (simulation.lazyMempool && simulation.txGossip) {
+		this->errorExit("Lazy mempools cannot be combined with transaction gossip");
+	}
+
+	if (simulation.trickleInterval <= 0) {
+		this->errorExit("Invalid trickle interval; it must be greater than 0");
+	}
+
+	if (simulation.txTraceTimeScale <= 0) {
+		this->errorExit("Invalid transaction trace time scale; it must be greater than 0");
+	}
+
+	if (simulation.matrixResolution < 0) {
+		this->errorExit("Invalid latency matrix resolution; it must not be negative");
+	}
+
+	if (simulation.bandwidth < 0) {
+		this->errorExit("Invalid bandwidth; it must not be negative");
+	}
+
+	if (simulation.compactBlocks && simulation.propagationMode != PROPAGATION_FLOOD) {
+		this->errorExit("Compact blocks require flood block propagation");
+	}
+
+	if (simulation.configPath.empty() == simulation.topologySpec.empty()) {
+		this->errorExit("Exactly one of configuration file (--config) and --topology is required");
+	}
+
+	if (simulation.blockRelay != BLOCK_RELAY_PUSH && simulation.propagationMode != PROPAGATION_FLOOD) {
+		this->errorExit("Block relay protocol can be changed only for flood block propagation");
+	}
+
+	if (simulation.compactBlocks && simulation.lazyMempool) {
+		this->errorExit("Compact blocks cannot be combined with lazy mempools");
+	}
+
+	if (simulation.churnRate < 0 || simulation.linkFailureRate < 0) {
+		this->errorExit("Invalid churn or link failure rate; it must not be negative");
+	}
+
+	if (simulation.churnDowntime <= 0 || simulation.linkDowntime <= 0) {
+		this->errorExit("Invalid churn or link downtime; it must be greater than 0");
+	}
+
+	if (simulation.coarsenThreshold < 0 || simulation.coarsenThreshold > 1) {
+		this->errorExit("Invalid coarsening threshold; it must be in interval <0, 1>");
+	}
+
+	if (simulation.blockHorizon <= 0) {
+		this->errorExit("Invalid block horizon; it must be greater than 0");
+	}
+
+	if (simulation.validationBase < 0 || simulation.validationPerTx < 0) {
+		this->errorExit("Invalid block validation time; it must not be negative");
+	}
+
 	return simulation;
 }
 
@@ -181,10 +567,51 @@ void ArgParser::printHelp() {
 	          << "  --lambda arg                block creation rate in seconds" << std::endl
 	          << "  --honest_random_remove      honest miners remove transactions randomly on full mempool" << std::endl
 	          << "  --mp_print_data             output mempool stats of all miners during simulation" << std::endl
+	          << "  --tx_arrival arg            transaction arrival process (uniform, poisson, bursty, diurnal, trace)"
+	          << std::endl
+	          << "  --tx_rate arg               mean transaction arrival rate per second (poisson, bursty, diurnal)"
+	          << std::endl
+	          << "  --tx_batch_interval arg     seconds of simulation time between arrival batches" << std::endl
+	          << "  --tx_burst_factor arg       arrival rate multiplier in burst state" << std::endl
+	          << "  --tx_burst_enter arg        probability of entering burst state per batch" << std::endl
+	          << "  --tx_burst_exit arg         probability of leaving burst state per batch" << std::endl
+	          << "  --tx_diurnal_amplitude arg  relative amplitude of diurnal arrival rate" << std::endl
+	          << "  --tx_diurnal_period arg     period of diurnal arrival rate in seconds" << std::endl
+	          << "  --tx_trace arg              binary transaction trace file (trace)" << std::endl
+	          << "  --tx_trace_time_scale arg   multiplier of trace time (trace)" << std::endl
+	          << "  --tx_trace_loop             replay the trace from the beginning when it is exhausted" << std::endl
+	          << "  --tx_gossip                 relay transactions over the topology instead of instant insertion"
+	          << std::endl
+	          << "  --trickle_interval arg      mean seconds between inventory batches sent by a miner" << std::endl
+	          << "  --lazy_mempool              reconstruct miner's mempool only when the miner mines a block"
+	          << std::endl
+	          << "  --propagation arg           block propagation model (flood, shortest_path, matrix)" << std::endl
+	          << "  --matrix_resolution arg     latency matrix resolution in seconds, 0 for full precision"
+	          << std::endl
+	          << "  --bandwidth arg             default link bandwidth in Mbit/s, 0 for unlimited" << std::endl
+	          << "  --tx_vsize arg              size of a transaction in bytes" << std::endl
+	          << "  --compact_blocks            relay blocks as compact blocks" << std::endl
+	          << "  --block_relay arg           block relay protocol of flood propagation (push, inv)" << std::endl
+	          << "  --topology gen:arg          generate topology instead of reading configuration file" << std::endl
+	          << "  --reorder arg               store miners in locality order (none, bfs, rcm, community)" << std::endl
+	          << "  --churn_rate arg            miner departures per second" << std::endl
+	          << "  --churn_downtime arg        mean seconds a departed miner stays offline" << std::endl
+	          << "  --link_failure_rate arg     link failures per second" << std::endl
+	          << "  --link_downtime arg         mean seconds a failed link stays down" << std::endl
+	          << "  --coarsen arg               collapse honest miners with mining power below arg into links" << std::endl
+	          << "  --consensus arg             ordering of the block DAG (depth, ghostdag, spectre)" << std::endl
+	          << "  --ghostdag_k arg            maximum anticone size of GHOSTDAG blue blocks" << std::endl
+	          << "  --no_data                   do not write included transactions, only count them" << std::endl
+	          << "  --validation_base arg       seconds to validate a received block" << std::endl
+	          << "  --validation_per_tx arg     seconds to validate a transaction of a received block" << std::endl
+	          << "  --block_horizon arg         seconds a block that did not reach all miners keeps its transactions"
+	          << std::endl
 	          << std::endl << "Configuration file options:" << std::endl
 	          << "  --description <text>" << std::endl
 	          << "  --miner <relative_power> <behavior>" << std::endl
-	          << "  --biconnect <miner1> <miner2> <block_prop_delay>" << std::endl;
+	          << "  --biconnect <miner1> <miner2> [block_prop_delay] [bandwidth]" << std::endl
+	          << "  --relay <miner1> <miner2> <block_prop_delay> [bandwidth]" << std::endl
+	          << "  --event <time> <link_down|link_up|node_down|node_up|partition> ..." << std::endl;
 }
 
 void ArgParser::errorExit(const std::string &msg) {
@@ -21,7 +21,14 @@ class Simulation;
 enum argumentOptions {
 	OPT_HELP, OPT_SEED, OPT_CONFIG, OPT_MP_CAPACITY, OPT_MAX_TX_GEN_COUNT, OPT_MIN_TX_GEN_COUNT,
 	OPT_MAX_TX_GEN_TIME, OPT_MIN_TX_GEN_TIME, OPT_BLOCK_SIZE, OPT_BLOCKS, OPT_LAMBDA, OPT_INIT_TX_COUNT,
-	OPT_HONEST_RAND_REMOVE, OPT_MP_PRINT_DATA, OPT_INVALID
+	OPT_HONEST_RAND_REMOVE, OPT_MP_PRINT_DATA, OPT_TX_ARRIVAL, OPT_TX_RATE, OPT_TX_BATCH_INTERVAL, OPT_TX_BURST_FACTOR,
+	OPT_TX_BURST_ENTER, OPT_TX_BURST_EXIT, OPT_TX_DIURNAL_AMPLITUDE, OPT_TX_DIURNAL_PERIOD, OPT_TX_TRACE,
+	OPT_TX_TRACE_TIME_SCALE, OPT_TX_TRACE_LOOP, OPT_TX_GOSSIP, OPT_TRICKLE_INTERVAL, OPT_LAZY_MEMPOOL, OPT_PROPAGATION,
+	OPT_MATRIX_RESOLUTION, OPT_BANDWIDTH, OPT_TX_VSIZE, OPT_COMPACT_BLOCKS, OPT_BLOCK_RELAY, OPT_TOPOLOGY, OPT_REORDER,
+	OPT_CHURN_RATE, OPT_CHURN_DOWNTIME, OPT_LINK_FAILURE_RATE, OPT_LINK_DOWNTIME, OPT_COARSEN, OPT_CONSENSUS,
+	OPT_GHOSTDAG_K, OPT_NO_DATA, OPT_VALIDATION_BASE, OPT_VALIDATION_PER_TX,
+	OPT_BLOCK_HORIZON,
+	OPT_INVALID
 };
 
 class ArgParser {
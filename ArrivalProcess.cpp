@@ -0,0 +1,103 @@
+/**
+ * @file ArrivalProcess.cpp
+ * @brief Transaction arrival processes that produce batched transaction generation schedules
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#include <cmath>
+#include <sstream>
+#include "ArrivalProcess.h"
+
+UniformArrivalProcess::UniformArrivalProcess(uint32_t minCount, uint32_t maxCount, uint32_t minTime,
+                                             uint32_t maxTime) : txGenCountDistribution(int(minCount), int(maxCount)),
+                                                                 txGenTimeDistribution(int(minTime), int(maxTime)) {
+}
+
+ArrivalBatch UniformArrivalProcess::nextBatch(double, std::mt19937 &randomGen) {
+	uint32_t txCount = txGenCountDistribution(randomGen);
+	uint32_t txWaitTime = txGenTimeDistribution(randomGen);
+
+	return {txCount, double(txWaitTime)};
+}
+
+std::string UniformArrivalProcess::describe() const {
+	std::stringstream ss;
+	ss << "uniform (count " << txGenCountDistribution.min() << "-" << txGenCountDistribution.max() << ", time "
+	   << txGenTimeDistribution.min() << "-" << txGenTimeDistribution.max() << " sec)";
+	return ss.str();
+}
+
+PoissonArrivalProcess::PoissonArrivalProcess(double rate, double _interval) : interval(_interval),
+                                                                              batchCountDistribution(
+		                                                                              rate * _interval) {
+}
+
+ArrivalBatch PoissonArrivalProcess::nextBatch(double, std::mt19937 &randomGen) {
+	return {batchCountDistribution(randomGen), interval};
+}
+
+std::string PoissonArrivalProcess::describe() const {
+	std::stringstream ss;
+	ss << "poisson (" << batchCountDistribution.mean() / interval << " tx/sec, batch " << interval << " sec)";
+	return ss.str();
+}
+
+BurstyArrivalProcess::BurstyArrivalProcess(double rate, double burstFactor, double _interval,
+                                           double _enterProbability, double _exitProbability)
+		: interval(_interval), enterProbability(_enterProbability), exitProbability(_exitProbability),
+		  inBurst(false), normalCountDistribution(rate * _interval),
+		  burstCountDistribution(rate * burstFactor * _interval), enterBurstDistribution(_enterProbability),
+		  exitBurstDistribution(_exitProbability) {
+}
+
+ArrivalBatch BurstyArrivalProcess::nextBatch(double, std::mt19937 &randomGen) {
+	// Markov chain transition is evaluated once per batch
+	if (inBurst) {
+		inBurst = !exitBurstDistribution(randomGen);
+	}
+	else {
+		inBurst = enterBurstDistribution(randomGen);
+	}
+
+	uint32_t txCount = inBurst ? burstCountDistribution(randomGen) : normalCountDistribution(randomGen);
+
+	return {txCount, interval};
+}
+
+std::string BurstyArrivalProcess::describe() const {
+	std::stringstream ss;
+	ss << "bursty (" << normalCountDistribution.mean() / interval << " tx/sec, burst "
+	   << burstCountDistribution.mean() / interval << " tx/sec, enter " << enterProbability << ", exit "
+	   << exitProbability << ", batch " << interval << " sec)";
+	return ss.str();
+}
+
+DiurnalArrivalProcess::DiurnalArrivalProcess(double _rate, double _amplitude, double _period, double _interval)
+		: rate(_rate), amplitude(_amplitude), period(_period), interval(_interval) {
+}
+
+double DiurnalArrivalProcess::cumulativeRate(double t) const {
+	// Closed form integral of rate(t), so a batch does not depend on its length
+	double omega = 2 * M_PI / period;
+	return rate * (t + amplitude * (1 - std::cos(omega * t)) / omega);
+}
+
+ArrivalBatch DiurnalArrivalProcess::nextBatch(double simTime, std::mt19937 &randomGen) {
+	double mean = cumulativeRate(simTime + interval) - cumulativeRate(simTime);
+	if (mean <= 0) {
+		return {0, interval};
+	}
+
+	std::poisson_distribution<uint32_t> batchCountDistribution(mean);
+
+	return {batchCountDistribution(randomGen), interval};
+}
+
+std::string DiurnalArrivalProcess::describe() const {
+	std::stringstream ss;
+	ss << "diurnal (" << rate << " tx/sec, amplitude " << amplitude << ", period " << period << " sec, batch "
+	   << interval << " sec)";
+	return ss.str();
+}
@@ -0,0 +1,156 @@
+/**
+ * @file ArrivalProcess.h
+ * @brief Transaction arrival processes that produce batched transaction generation schedules
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef ARRIVALPROCESS_H
+#define ARRIVALPROCESS_H
+
+#include <string>
+#include <random>
+#include <cstdint>
+
+enum ArrivalProcessType {
+	ARRIVAL_UNIFORM,
+	ARRIVAL_POISSON,
+	ARRIVAL_BURSTY,
+	ARRIVAL_DIURNAL,
+	ARRIVAL_TRACE
+};
+
+class TraceRecord;
+
+class ArrivalBatch {
+public:
+	uint32_t txCount;
+	double waitTime;    // Seconds of simulation time until the next batch
+	const TraceRecord *records = nullptr;   // Recorded transactions of the batch, nullptr for synthetic processes
+};
+
+class ArrivalProcess {
+public:
+	virtual ~ArrivalProcess() = default;
+
+	/**
+	 * @brief Draw the next generation batch, each call is O(1) regardless of the number of transactions
+	 * @param simTime current simulation time in seconds
+	 * @param randomGen Random generator
+	 * @return Number of transactions in the batch and time to the next batch
+	 */
+	virtual ArrivalBatch nextBatch(double simTime, std::mt19937 &randomGen) = 0;
+
+	/**
+	 *
+	 * @return Human readable description of the process and its parameters
+	 */
+	virtual std::string describe() const = 0;
+};
+
+/**
+ * @brief Original generation model, uniformly distributed batch size and uniformly distributed batch spacing
+ */
+class UniformArrivalProcess : public ArrivalProcess {
+	std::uniform_int_distribution<> txGenCountDistribution;
+	std::uniform_int_distribution<> txGenTimeDistribution;
+
+public:
+	/**
+	 *
+	 * @param minCount minimum number of transactions in single generation
+	 * @param maxCount maximum number of transactions in single generation
+	 * @param minTime minimum seconds to the next generation
+	 * @param maxTime maximum seconds to the next generation
+	 */
+	UniformArrivalProcess(uint32_t minCount, uint32_t maxCount, uint32_t minTime, uint32_t maxTime);
+
+	ArrivalBatch nextBatch(double simTime, std::mt19937 &randomGen) override;
+
+	std::string describe() const override;
+};
+
+/**
+ * @brief Homogeneous Poisson process observed in fixed batch intervals
+ */
+class PoissonArrivalProcess : public ArrivalProcess {
+	double interval;
+	std::poisson_distribution<uint32_t> batchCountDistribution;
+
+public:
+	/**
+	 *
+	 * @param rate mean number of transactions per second
+	 * @param _interval batch interval in seconds
+	 */
+	PoissonArrivalProcess(double rate, double _interval);
+
+	ArrivalBatch nextBatch(double simTime, std::mt19937 &randomGen) override;
+
+	std::string describe() const override;
+};
+
+/**
+ * @brief Two state Markov-modulated Poisson process (normal and burst state), state may switch once per batch
+ */
+class BurstyArrivalProcess : public ArrivalProcess {
+	double interval;
+	double enterProbability;
+	double exitProbability;
+	bool inBurst;
+	std::poisson_distribution<uint32_t> normalCountDistribution;
+	std::poisson_distribution<uint32_t> burstCountDistribution;
+	std::bernoulli_distribution enterBurstDistribution;
+	std::bernoulli_distribution exitBurstDistribution;
+
+public:
+	/**
+	 *
+	 * @param rate mean number of transactions per second in normal state
+	 * @param burstFactor rate multiplier in burst state
+	 * @param _interval batch interval in seconds
+	 * @param _enterProbability probability of switching from normal to burst state per batch
+	 * @param _exitProbability probability of switching from burst to normal state per batch
+	 */
+	BurstyArrivalProcess(double rate, double burstFactor, double _interval, double _enterProbability,
+	                     double _exitProbability);
+
+	ArrivalBatch nextBatch(double simTime, std::mt19937 &randomGen) override;
+
+	std::string describe() const override;
+};
+
+/**
+ * @brief Non-homogeneous Poisson process with sinusoidal (day/night) rate
+ * rate(t) = rate * (1 + amplitude * sin(2 * pi * t / period))
+ */
+class DiurnalArrivalProcess : public ArrivalProcess {
+	double rate;
+	double amplitude;
+	double period;
+	double interval;
+
+	/**
+	 *
+	 * @param t simulation time in seconds
+	 * @return Expected number of arrivals in interval <0, t>
+	 */
+	double cumulativeRate(double t) const;
+
+public:
+	/**
+	 *
+	 * @param _rate mean number of transactions per second
+	 * @param _amplitude relative amplitude of the rate in interval <0, 1>
+	 * @param _period period of the rate in seconds
+	 * @param _interval batch interval in seconds
+	 */
+	DiurnalArrivalProcess(double _rate, double _amplitude, double _period, double _interval);
+
+	ArrivalBatch nextBatch(double simTime, std::mt19937 &randomGen) override;
+
+	std::string describe() const override;
+};
+
+#endif //ARRIVALPROCESS_H
@@ -11,3 +11,11 @@
 Block::Block(uint32_t _id, uint32_t _depth, uint32_t blockSize): id(_id), depth(_depth) {
 	transactions.reserve(blockSize);
 }
+
+double Block::byteSize() const {
+	return BLOCK_HEADER_SIZE + double(txBytes);
+}
+
+double Block::compactByteSize() const {
+	return BLOCK_HEADER_SIZE + COMPACT_BLOCK_NONCE_SIZE + double(txCount) * COMPACT_BLOCK_SHORT_ID_SIZE;
+}
@@ -11,10 +11,16 @@
 
 #include <vector>
 #include <cstdint>
+#include "TxTable.h"
+
+// Serialized sizes in bytes as in Bitcoin
+const uint32_t BLOCK_HEADER_SIZE = 80;
+const uint32_t COMPACT_BLOCK_NONCE_SIZE = 8;
+const uint32_t COMPACT_BLOCK_SHORT_ID_SIZE = 6;
 
 class Transaction {
 public:
-	uint64_t txId;
+	TxHandle handle;
 	uint32_t fee;
 };
 
@@ -22,6 +28,8 @@ class Block {
 public:
 	uint32_t id;
 	uint32_t depth;
+	uint32_t txCount = 0;   // Number of transactions, kept when the transactions are released
+	uint64_t txBytes = 0;   // Sum of sizes of the transactions
 	std::vector<Transaction> transactions;
 
 	/**
@@ -31,6 +39,18 @@ public:
 	 * @param blockSize number of transactions in the block
 	 */
 	Block(uint32_t _id, uint32_t _depth, uint32_t blockSize);
+
+	/**
+	 *
+	 * @return Size of the full block in bytes
+	 */
+	double byteSize() const;
+
+	/**
+	 * @brief Compact block (BIP 152) carries header and short ids of transactions instead of transactions
+	 * @return Size of the compact block in bytes
+	 */
+	double compactByteSize() const;
 };
 
 #endif //BLOCK_H
@@ -0,0 +1,26 @@
+/**
+ * @file BlockDag.cpp
+ * @brief Directed acyclic graph of blocks, each block references all tips known to its miner
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#include <stdexcept>
+#include "BlockDag.h"
+
+void BlockDag::addBlock(uint32_t blockId, const std::vector<uint32_t> &blockParents) {
+	if (blockId != blockCount()) {
+		throw std::logic_error("Blocks have to be added to the DAG in the order of their ids");
+	}
+
+	firstChildReferences.push_back(DAG_NO_REFERENCE);
+	for (uint32_t parent: blockParents) {
+		auto reference = uint32_t(parents.size());
+		parents.push_back(parent);
+		referenceBlocks.push_back(blockId);
+		nextChildReferences.push_back(firstChildReferences[parent]);
+		firstChildReferences[parent] = reference;
+	}
+	offsets.push_back(uint32_t(parents.size()));
+}
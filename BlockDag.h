@@ -0,0 +1,109 @@
+/**
+ * @file BlockDag.h
+ * @brief Directed acyclic graph of blocks, each block references all tips known to its miner
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef BLOCKDAG_H
+#define BLOCKDAG_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+const uint32_t DAG_NO_REFERENCE = UINT32_MAX;
+
+enum ConsensusMode {
+	CONSENSUS_DEPTH,    // Blocks are only ordered by depth
+	CONSENSUS_GHOSTDAG, // Blue set and total order of GHOSTDAG computed for each mined block
+	CONSENSUS_SPECTRE   // Pairwise SPECTRE votes, ancestry from the index built by GHOSTDAG
+};
+
+// Names used in program arguments and outputs, indexed by ConsensusMode
+const char *const CONSENSUS_NAMES[] = {"depth", "ghostdag", "spectre"};
+
+/**
+ * @brief Parent references of all blocks are stored in a single arena in the order of block ids, parents of block b
+ * are in interval <offsets[b], offsets[b + 1]). Each reference is also linked into the list of children of its
+ * parent, so both directions take memory linear in the number of references.
+ */
+class BlockDag {
+	std::vector<uint32_t> offsets{0};
+	std::vector<uint32_t> parents;
+	std::vector<uint32_t> referenceBlocks;      // Block that holds each reference
+	std::vector<uint32_t> nextChildReferences;  // Next reference to the same parent
+	std::vector<uint32_t> firstChildReferences; // First reference to each block
+
+public:
+	/**
+	 * @brief Append a block, blocks are added in the order of their ids
+	 * @param blockId id of the block, equal to the number of blocks in the DAG
+	 * @param blockParents ids of parent blocks
+	 */
+	void addBlock(uint32_t blockId, const std::vector<uint32_t> &blockParents);
+
+	/**
+	 *
+	 * @return Number of blocks
+	 */
+	inline uint32_t blockCount() const {
+		return uint32_t(offsets.size() - 1);
+	}
+
+	/**
+	 *
+	 * @return Number of parent references of all blocks
+	 */
+	inline size_t referenceCount() const {
+		return parents.size();
+	}
+
+	/**
+	 *
+	 * @param blockId id of a block
+	 * @return Pointer to the first parent of the block
+	 */
+	inline const uint32_t *parentsBegin(uint32_t blockId) const {
+		return parents.data() + offsets[blockId];
+	}
+
+	/**
+	 *
+	 * @param blockId id of a block
+	 * @return Pointer after the last parent of the block
+	 */
+	inline const uint32_t *parentsEnd(uint32_t blockId) const {
+		return parents.data() + offsets[blockId + 1];
+	}
+
+	/**
+	 *
+	 * @param blockId id of a block
+	 * @return First reference to the block, DAG_NO_REFERENCE if the block has no children
+	 */
+	inline uint32_t firstChildReference(uint32_t blockId) const {
+		return firstChildReferences[blockId];
+	}
+
+	/**
+	 *
+	 * @param reference reference index
+	 * @return Next reference to the same parent, DAG_NO_REFERENCE if there is none
+	 */
+	inline uint32_t nextChildReference(uint32_t reference) const {
+		return nextChildReferences[reference];
+	}
+
+	/**
+	 *
+	 * @param reference reference index
+	 * @return Child block that holds the reference
+	 */
+	inline uint32_t referenceBlock(uint32_t reference) const {
+		return referenceBlocks[reference];
+	}
+};
+
+#endif //BLOCKDAG_H
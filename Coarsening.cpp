@@ -0,0 +1,191 @@
+/**
+ * @file Coarsening.cpp
+ * @brief Collapse relay nodes with negligible mining power into equivalent links between significant miners
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#include <map>
+#include <queue>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include "Coarsening.h"
+#include "Propagation.h"
+
+/**
+ * @brief Link of the coarsened graph, transmission times of hops add up, so inverse bandwidths are summed
+ */
+class CoarseEdge {
+public:
+	double latency;
+	double inverseBandwidth;    // Seconds per byte, 0 for unlimited
+
+	inline double length(double blockBytes) const {
+		return latency + blockBytes * inverseBandwidth;
+	}
+};
+
+CoarseNetwork coarsenTopology(const Topology &topology, const std::vector<bool> &candidates, double blockBytes) {
+	uint32_t nodeCount = topology.nodeCount();
+
+	// Ordered maps keep the elimination deterministic, degrees of eliminated nodes are small
+	std::vector<std::map<uint32_t, CoarseEdge>> adjacency(nodeCount);
+	for (uint32_t node = 0; node < nodeCount; node++) {
+		for (uint32_t edge = topology.edgesBegin(node); edge < topology.edgesEnd(node); edge++) {
+			uint32_t peer = topology.neighbor(edge);
+			double bandwidth = topology.bandwidth(edge);
+			CoarseEdge coarseEdge{topology.latency(edge), bandwidth > 0 ? 1.0 / bandwidth : 0};
+
+			auto it = adjacency[node].find(peer);
+			if (peer != node && (it == adjacency[node].end() ||
+			                     coarseEdge.length(blockBytes) < it->second.length(blockBytes))) {
+				adjacency[node][peer] = coarseEdge;
+			}
+		}
+	}
+
+	std::vector<bool> eliminated(nodeCount, false);
+	std::vector<bool> queued(nodeCount, true);
+	std::queue<uint32_t> worklist;
+	for (uint32_t node = 0; node < nodeCount; node++) {
+		worklist.push(node);
+	}
+
+	while (!worklist.empty()) {
+		uint32_t node = worklist.front();
+		worklist.pop();
+		queued[node] = false;
+
+		// Isolated node stays, it represents its component
+		std::map<uint32_t, CoarseEdge> &neighbors = adjacency[node];
+		if (!candidates[node] || neighbors.empty() || neighbors.size() > COARSEN_MAX_DEGREE) {
+			continue;
+		}
+
+		size_t addedLinks = 0;
+		for (auto first = neighbors.begin(); first != neighbors.end(); ++first) {
+			for (auto second = std::next(first); second != neighbors.end(); ++second) {
+				addedLinks += adjacency[first->first].count(second->first) == 0;
+			}
+		}
+		if (addedLinks > neighbors.size()) {
+			continue;
+		}
+
+		// Shortcuts replace paths over the node
+		for (auto first = neighbors.begin(); first != neighbors.end(); ++first) {
+			for (auto second = std::next(first); second != neighbors.end(); ++second) {
+				CoarseEdge shortcut{first->second.latency + second->second.latency,
+				                    first->second.inverseBandwidth + second->second.inverseBandwidth};
+
+				auto it = adjacency[first->first].find(second->first);
+				if (it == adjacency[first->first].end() ||
+				    shortcut.length(blockBytes) < it->second.length(blockBytes)) {
+					adjacency[first->first][second->first] = shortcut;
+					adjacency[second->first][first->first] = shortcut;
+				}
+			}
+		}
+
+		for (auto &[peer, coarseEdge]: neighbors) {
+			adjacency[peer].erase(node);
+			if (!queued[peer]) {
+				queued[peer] = true;
+				worklist.push(peer);
+			}
+		}
+		neighbors.clear();
+		eliminated[node] = true;
+	}
+
+	CoarseNetwork network;
+	std::vector<uint32_t> newIndices(nodeCount, 0);
+	for (uint32_t node = 0; node < nodeCount; node++) {
+		if (!eliminated[node]) {
+			newIndices[node] = uint32_t(network.retained.size());
+			network.retained.push_back(node);
+		}
+	}
+
+	for (uint32_t node: network.retained) {
+		for (auto &[peer, coarseEdge]: adjacency[node]) {
+			if (node < peer) {
+				double bandwidth = coarseEdge.inverseBandwidth > 0 ? 1.0 / coarseEdge.inverseBandwidth : 0;
+				network.links.push_back({newIndices[node], newIndices[peer], coarseEdge.latency, bandwidth});
+			}
+		}
+	}
+
+	// Eliminated nodes belong to the closest retained node, every component keeps at least one node
+	typedef std::pair<double, uint32_t> QueueItem;
+	std::vector<double> distances(nodeCount, std::numeric_limits<double>::infinity());
+	network.owners.assign(nodeCount, 0);
+	std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>> queue;
+	for (uint32_t node: network.retained) {
+		distances[node] = 0;
+		network.owners[node] = newIndices[node];
+		queue.push({0, node});
+	}
+
+	while (!queue.empty()) {
+		auto [distance, node] = queue.top();
+		queue.pop();
+
+		if (distance > distances[node]) {
+			continue;
+		}
+
+		for (uint32_t edge = topology.edgesBegin(node); edge < topology.edgesEnd(node); edge++) {
+			uint32_t peer = topology.neighbor(edge);
+			double peerDistance = distance + topology.latency(edge) + topology.transmissionDelay(edge, blockBytes);
+			if (peerDistance < distances[peer]) {
+				distances[peer] = peerDistance;
+				network.owners[peer] = network.owners[node];
+				queue.push({peerDistance, peer});
+			}
+		}
+	}
+
+	return network;
+}
+
+CoarseningError measureCoarseningError(const Topology &topology, const Topology &relayTopology,
+                                       const Topology &coarseTopology, const Topology &coarseRelayTopology,
+                                       const std::vector<uint32_t> &retained, double blockBytes) {
+	CoarseningError error;
+	if (retained.empty()) {
+		return error;
+	}
+
+	std::vector<double> latencies;
+	std::vector<double> coarseLatencies;
+	double errorSum = 0;
+	uint64_t pairs = 0;
+
+	// Sources are spread evenly over retained miners
+	uint32_t sources = std::min(COARSEN_ERROR_SOURCES, uint32_t(retained.size()));
+	for (uint32_t i = 0; i < sources; i++) {
+		auto source = uint32_t(uint64_t(i) * retained.size() / sources);
+		shortestLatencies(topology, relayTopology, retained[source], blockBytes, latencies, nullptr);
+		shortestLatencies(coarseTopology, coarseRelayTopology, source, blockBytes, coarseLatencies, nullptr);
+
+		for (uint32_t node = 0; node < retained.size(); node++) {
+			double latency = latencies[retained[node]];
+			if (latency == std::numeric_limits<double>::infinity() ||
+			    coarseLatencies[node] == std::numeric_limits<double>::infinity()) {
+				continue;
+			}
+
+			double difference = std::abs(coarseLatencies[node] - latency);
+			error.maxError = std::max(error.maxError, difference);
+			errorSum += difference;
+			pairs++;
+		}
+	}
+
+	error.meanError = pairs > 0 ? errorSum / double(pairs) : 0;
+	return error;
+}
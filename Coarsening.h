@@ -0,0 +1,67 @@
+/**
+ * @file Coarsening.h
+ * @brief Collapse relay nodes with negligible mining power into equivalent links between significant miners
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef COARSENING_H
+#define COARSENING_H
+
+#include <vector>
+#include <cstdint>
+#include "Topology.h"
+
+// Node is eliminated only if its shortcuts do not add more links than the node removes
+const uint32_t COARSEN_MAX_DEGREE = 16;
+
+// Number of retained miners used as sources when the error of coarsened topology is measured
+const uint32_t COARSEN_ERROR_SOURCES = 16;
+
+/**
+ * @brief Topology with eliminated nodes, nodes are renumbered in the order of their original indices
+ */
+class CoarseNetwork {
+public:
+	std::vector<uint32_t> retained;     // Original index of each retained node
+	std::vector<uint32_t> owners;       // New index of the retained node closest to each original node
+	std::vector<Link> links;            // Links between retained nodes with new indices
+};
+
+/**
+ * @brief Arrival time difference of coarsened and original topology measured over retained miners
+ */
+class CoarseningError {
+public:
+	double maxError = 0;    // Seconds
+	double meanError = 0;   // Seconds
+};
+
+/**
+ * @brief Candidate nodes are eliminated one by one, neighbors of an eliminated node are connected by a shortcut with
+ * the sum of latencies (and transmission times) unless they already have a shorter link, so shortest paths between
+ * remaining nodes do not change. Chains and leaves of candidates are always eliminated, a candidate connecting many
+ * nodes is kept if its shortcuts would add more links than it removes.
+ * @param topology network topology
+ * @param candidates nodes that may be eliminated
+ * @param blockBytes size of a block, link length is latency plus block transmission time
+ * @return Coarsened network
+ */
+CoarseNetwork coarsenTopology(const Topology &topology, const std::vector<bool> &candidates, double blockBytes);
+
+/**
+ * @brief Compare shortest arrival times without jitter from a sample of retained miners
+ * @param topology original topology
+ * @param relayTopology original relay network overlay
+ * @param coarseTopology coarsened topology
+ * @param coarseRelayTopology relay network overlay with new indices
+ * @param retained original index of each retained node
+ * @param blockBytes size of a block
+ * @return Measured error
+ */
+CoarseningError measureCoarseningError(const Topology &topology, const Topology &relayTopology,
+                                       const Topology &coarseTopology, const Topology &coarseRelayTopology,
+                                       const std::vector<uint32_t> &retained, double blockBytes);
+
+#endif //COARSENING_H
@@ -7,8 +7,13 @@
  */
 
 #include "ConfigParser.h"
+#include "distributionData/BlockPropagationDelay.h"
 
-std::vector<Miner> ConfigParser::parseConfig(Simulation &simulation) const {
+// Built at compile time, generated connection delays are drawn in constant time
+constexpr AliasTable<std::size(blockPropDelayData)> blockPropDelayTable{blockPropDelayData};
+
+std::vector<Miner> ConfigParser::parseConfig(Simulation &simulation, std::vector<Link> &links,
+                                             std::vector<Link> &relayLinks, std::vector<TopologyEvent> &events) const {
 	std::ifstream cfgFile(simulation.getConfigPath());
 
 	// Check if specified data file can be opened
@@ -17,7 +22,6 @@ std::vector<Miner> ConfigParser::parseConfig(Simulation &simulation) const {
 	}
 
 	std::vector<Miner> miners{};
-	std::discrete_distribution<> blockPropDelayDistribution(blockPropDelayData);
 	double totalMiningPower = 0;
 
 	std::string line;
@@ -73,17 +77,22 @@ std::vector<Miner> ConfigParser::parseConfig(Simulation &simulation) const {
 
 			totalMiningPower += totalMiningPower;
 		}
-		else if (name == "biconnect") {
-			// Validate number of tokens. Last token (connection delay) is optional and if not provided
-			// it will be generated by distribution with data from Bitcoin network
-			if (tokens.size() != BICONN_TOKEN_COUNT && tokens.size() != BICONN_TOKEN_COUNT + 1) {
+		else if (name == "biconnect" || name == "relay") {
+			// Validate number of tokens. Connection delay is optional and if not provided it will be generated by
+			// distribution with data from Bitcoin network. Bandwidth is optional and requires connection delay.
+			if (tokens.size() < BICONN_TOKEN_COUNT || tokens.size() > BICONN_TOKEN_COUNT + 2) {
 				throw std::runtime_error(
 						"Invalid configuration file structure - bi-connect contains invalid number of tokens");
 			}
 
+			// Relay network link has its own latency class, delay of P2P links does not apply to it
+			if (name == "relay" && tokens.size() == BICONN_TOKEN_COUNT) {
+				throw std::runtime_error("Invalid configuration file structure - relay link requires delay");
+			}
+
 			bool generateConnectionDelay = false;
 
-			if (tokens.size() == BICONN_TOKEN_COUNT + 1) {
+			if (tokens.size() >= BICONN_TOKEN_COUNT + 1) {
 				generateConnectionDelay = true;
 			}
 
@@ -95,6 +104,7 @@ std::vector<Miner> ConfigParser::parseConfig(Simulation &simulation) const {
 			uint32_t miner1Index;
 			uint32_t miner2Index;
 			double connectionDelay;
+			double bandwidth = simulation.getBandwidth();
 
 			try {
 				miner1Index = std::stoul(tokens[0]);
@@ -104,7 +114,11 @@ std::vector<Miner> ConfigParser::parseConfig(Simulation &simulation) const {
 					connectionDelay = std::stod(tokens[2]);
 				}
 				else {
-					connectionDelay = blockPropDelayDistribution(simulation.getRandomGen());
+					connectionDelay = double(blockPropDelayTable(simulation.getRandomGen()));
+				}
+
+				if (tokens.size() == BICONN_TOKEN_COUNT + 2) {
+					bandwidth = std::stod(tokens[3]);
 				}
 			}
 			catch (std::exception &e) {
@@ -121,11 +135,24 @@ std::vector<Miner> ConfigParser::parseConfig(Simulation &simulation) const {
 						"Invalid configuration file structure - bi-connection contains negative delay");
 			}
 
-			// Convert delay from ms to s
+			if (bandwidth < 0) {
+				throw std::runtime_error(
+						"Invalid configuration file structure - bi-connection contains negative bandwidth");
+			}
+
+			// Convert delay from ms to s and bandwidth from Mbit/s to B/s
 			connectionDelay /= 1000;
+			bandwidth *= 1000000.0 / 8;
 
-			miners[miner1Index].addPeer(miners[miner2Index], connectionDelay);
-			miners[miner2Index].addPeer(miners[miner1Index], connectionDelay);
+			if (name == "relay") {
+				relayLinks.push_back({miner1Index, miner2Index, connectionDelay, bandwidth});
+			}
+			else {
+				links.push_back({miner1Index, miner2Index, connectionDelay, bandwidth});
+			}
+		}
+		else if (name == "event") {
+			events.push_back(parseEvent(tokens, miners.size(), simulation.getBandwidth()));
 		}
 	}
 
@@ -137,3 +164,93 @@ std::vector<Miner> ConfigParser::parseConfig(Simulation &simulation) const {
 
 	return miners;
 }
+
+TopologyEvent ConfigParser::parseEvent(const std::vector<std::string> &tokens, size_t minerCount,
+                                       double bandwidth) const {
+	if (tokens.size() < EVENT_TOKEN_COUNT) {
+		throw std::runtime_error("Invalid configuration file structure - event contains invalid number of tokens");
+	}
+
+	TopologyEvent event{};
+	const std::string &type = tokens[1];
+
+	// Number of miner tokens and optional tokens after them
+	size_t minerTokens;
+	size_t optionalTokens = 0;
+	size_t firstMiner = EVENT_TOKEN_COUNT;
+
+	if (type == "link_down") {
+		event.type = EVENT_LINK_DOWN;
+		minerTokens = 2;
+	}
+	else if (type == "link_up") {
+		event.type = EVENT_LINK_UP;
+		minerTokens = 2;
+		optionalTokens = 2;
+	}
+	else if (type == "node_down") {
+		event.type = EVENT_NODE_DOWN;
+		minerTokens = 1;
+	}
+	else if (type == "node_up") {
+		event.type = EVENT_NODE_UP;
+		minerTokens = 1;
+	}
+	else if (type == "partition") {
+		event.type = EVENT_PARTITION;
+		firstMiner++;
+		minerTokens = tokens.size() > firstMiner ? tokens.size() - firstMiner : 1;
+	}
+	else {
+		throw std::runtime_error("Invalid configuration file structure - event contains invalid type");
+	}
+
+	if (tokens.size() < firstMiner + minerTokens || tokens.size() > firstMiner + minerTokens + optionalTokens) {
+		throw std::runtime_error("Invalid configuration file structure - event contains invalid number of tokens");
+	}
+
+	event.link.bandwidth = bandwidth;
+	try {
+		event.time = std::stod(tokens[0]);
+		if (event.type == EVENT_PARTITION) {
+			event.duration = std::stod(tokens[2]);
+		}
+
+		for (size_t i = firstMiner; i < firstMiner + minerTokens; i++) {
+			event.miners.push_back(std::stoul(tokens[i]));
+		}
+
+		if (tokens.size() > firstMiner + minerTokens) {
+			event.link.latency = std::stod(tokens[firstMiner + minerTokens]);
+			event.hasLatency = true;
+		}
+		if (tokens.size() > firstMiner + minerTokens + 1) {
+			event.link.bandwidth = std::stod(tokens[firstMiner + minerTokens + 1]);
+		}
+	}
+	catch (std::exception &e) {
+		throw std::runtime_error("Invalid configuration file structure - invalid event");
+	}
+
+	for (uint32_t miner: event.miners) {
+		if (miner >= minerCount) {
+			throw std::runtime_error("Invalid configuration file structure - event contains undefined miner");
+		}
+	}
+
+	if (event.time < 0 || event.duration < 0 || (event.hasLatency && event.link.latency < 0) ||
+	    event.link.bandwidth < 0) {
+		throw std::runtime_error("Invalid configuration file structure - event contains negative value");
+	}
+
+	if (minerTokens == 2) {
+		event.link.miner1 = event.miners[0];
+		event.link.miner2 = event.miners[1];
+	}
+
+	// Convert delay from ms to s and bandwidth from Mbit/s to B/s
+	event.link.latency /= 1000;
+	event.link.bandwidth *= 1000000.0 / 8;
+
+	return event;
+}
@@ -17,7 +17,8 @@
 #include <random>
 #include "Simulation.h"
 #include "Miner.h"
-#include "distributionData/BlockPropagationDelay.h"
+#include "Topology.h"
+#include "TopologyEvent.h"
 
 class Miner;
 
@@ -31,13 +32,29 @@ class ConfigParser {
 	// Required number of tokens for bidirectional connection definition
 	const size_t BICONN_TOKEN_COUNT = 2;
 
+	// Minimum number of tokens for topology event definition, time and type
+	const size_t EVENT_TOKEN_COUNT = 2;
+
+	/**
+	 *
+	 * @param tokens tokens of event line
+	 * @param minerCount number of miners defined before the event
+	 * @param bandwidth default link bandwidth in Mbit/s
+	 * @return Parsed topology event
+	 */
+	TopologyEvent parseEvent(const std::vector<std::string> &tokens, size_t minerCount, double bandwidth) const;
+
 public:
 	/**
 	 *
 	 * @param simulation Simulator instance
+	 * @param links output of parsed bidirectional connections
+	 * @param relayLinks output of parsed connections of the relay network overlay
+	 * @param events output of parsed topology events
 	 * @return parsed and created miners from config
 	 */
-	std::vector<Miner> parseConfig(Simulation &simulation) const;
+	std::vector<Miner> parseConfig(Simulation &simulation, std::vector<Link> &links, std::vector<Link> &relayLinks,
+	                               std::vector<TopologyEvent> &events) const;
 };
 
 
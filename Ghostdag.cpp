@@ -0,0 +1,296 @@
+/**
+ * @file Ghostdag.cpp
+ * @brief Incremental GHOSTDAG, blue set, blue score and selected parent of each block computed when it is mined
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include "Ghostdag.h"
+
+void Ghostdag::init(const BlockDag *_dag, uint32_t _k) {
+	dag = _dag;
+	k = _k;
+	blocks.clear();
+	mergesets.clear();
+	anticoneBlocks.clear();
+	anticoneSizes.clear();
+	reachability = ReachabilityIndex();
+	sink = GHOSTDAG_NO_BLOCK;
+	mergesetStamps.clear();
+	mergesetStamp = 0;
+	ancestryQueries = 0;
+}
+
+void Ghostdag::addBlock(uint32_t blockId) {
+	if (blockId != blocks.size() || blockId >= dag->blockCount()) {
+		throw std::logic_error("Blocks have to be added to GHOSTDAG in the order of their ids after the DAG");
+	}
+
+	GhostdagBlockData data;
+	computeData(dag->parentsBegin(blockId), dag->parentsEnd(blockId), data);
+
+	GhostdagBlock block{};
+	block.selectedParent = data.selectedParent;
+	block.blueScore = data.blueScore;
+	block.mergesetOffset = uint32_t(mergesets.size());
+	block.blueCount = uint32_t(data.blues.size());
+	block.redCount = uint32_t(data.reds.size());
+	mergesets.insert(mergesets.end(), data.blues.begin(), data.blues.end());
+	mergesets.insert(mergesets.end(), data.reds.begin(), data.reds.end());
+
+	block.anticoneOffset = uint32_t(anticoneBlocks.size());
+	block.anticoneCount = uint32_t(data.anticoneBlocks.size());
+	anticoneBlocks.insert(anticoneBlocks.end(), data.anticoneBlocks.begin(), data.anticoneBlocks.end());
+	anticoneSizes.insert(anticoneSizes.end(), data.anticoneSizes.begin(), data.anticoneSizes.end());
+
+	blocks.push_back(block);
+	mergesetStamps.push_back(0);
+
+	// Mergeset without the selected parent is stored right after it
+	const uint32_t *mergeset = mergesets.data() + block.mergesetOffset;
+	reachability.addBlock(blockId, block.selectedParent, mergeset + std::min(block.blueCount, 1u),
+	                      mergeset + block.blueCount + block.redCount);
+
+	if (sink == GHOSTDAG_NO_BLOCK || mergesetLess(sink, blockId)) {
+		sink = blockId;
+	}
+}
+
+void Ghostdag::computeData(const uint32_t *parentsBegin, const uint32_t *parentsEnd, GhostdagBlockData &data) {
+	data = GhostdagBlockData();
+	for (const uint32_t *parent = parentsBegin; parent != parentsEnd; parent++) {
+		if (data.selectedParent == GHOSTDAG_NO_BLOCK || mergesetLess(data.selectedParent, *parent)) {
+			data.selectedParent = *parent;
+		}
+	}
+
+	if (data.selectedParent == GHOSTDAG_NO_BLOCK) {
+		return;
+	}
+
+	data.blues.push_back(data.selectedParent);
+	data.anticoneBlocks.push_back(data.selectedParent);
+	data.anticoneSizes.push_back(0);
+
+	computeMergeset(parentsBegin, parentsEnd, data.selectedParent, mergesetCandidates);
+	for (uint32_t candidate: mergesetCandidates) {
+		uint32_t anticoneSize = 0;
+		if (!checkBlueCandidate(data, candidate, anticoneSize)) {
+			data.reds.push_back(candidate);
+			continue;
+		}
+
+		data.blues.push_back(candidate);
+		data.anticoneBlocks.push_back(candidate);
+		data.anticoneSizes.push_back(anticoneSize);
+
+		// Blues in the anticone of the candidate get one more blue in their anticone
+		for (size_t i = 0; i < candidateBlues.size(); i++) {
+			auto it = std::find(data.anticoneBlocks.begin(), data.anticoneBlocks.end(), candidateBlues[i]);
+			if (it == data.anticoneBlocks.end()) {
+				data.anticoneBlocks.push_back(candidateBlues[i]);
+				data.anticoneSizes.push_back(candidateSizes[i] + 1);
+			} else {
+				data.anticoneSizes[it - data.anticoneBlocks.begin()] = candidateSizes[i] + 1;
+			}
+		}
+	}
+
+	data.blueScore = blocks[data.selectedParent].blueScore + uint32_t(data.blues.size());
+}
+
+void Ghostdag::computeMergeset(const uint32_t *parentsBegin, const uint32_t *parentsEnd, uint32_t selectedParent,
+                               std::vector<uint32_t> &mergeset) {
+	mergeset.clear();
+	std::vector<uint32_t> queue;
+	for (const uint32_t *parent = parentsBegin; parent != parentsEnd; parent++) {
+		if (*parent != selectedParent) {
+			queue.push_back(*parent);
+		}
+	}
+
+	mergesetStamp++;
+	while (!queue.empty()) {
+		uint32_t blockId = queue.back();
+		queue.pop_back();
+
+		if (mergesetStamps[blockId] == mergesetStamp) {
+			continue;
+		}
+		mergesetStamps[blockId] = mergesetStamp;
+		if (isAncestor(blockId, selectedParent)) {
+			continue;
+		}
+
+		mergeset.push_back(blockId);
+		for (const uint32_t *parent = dag->parentsBegin(blockId); parent != dag->parentsEnd(blockId); parent++) {
+			if (*parent != selectedParent) {
+				queue.push_back(*parent);
+			}
+		}
+	}
+
+	std::sort(mergeset.begin(), mergeset.end(), [this](uint32_t first, uint32_t second) {
+		return mergesetLess(first, second);
+	});
+}
+
+bool Ghostdag::checkBlueCandidate(const GhostdagBlockData &data, uint32_t candidate, uint32_t &anticoneSize) {
+	candidateBlues.clear();
+	candidateSizes.clear();
+	anticoneSize = 0;
+
+	if (data.blues.size() == k + 1) {
+		return false;
+	}
+
+	if (!checkChainBlues(data, data.blues.data(), data.blues.data() + data.blues.size(), candidate, anticoneSize)) {
+		return false;
+	}
+
+	// Blues of chain blocks in the past of the candidate are all in the past of the candidate
+	for (uint32_t chainBlock = data.selectedParent; chainBlock != GHOSTDAG_NO_BLOCK;
+	     chainBlock = blocks[chainBlock].selectedParent) {
+		if (isAncestor(chainBlock, candidate)) {
+			return true;
+		}
+
+		const uint32_t *blues = mergesets.data() + blocks[chainBlock].mergesetOffset;
+		if (!checkChainBlues(data, blues, blues + blocks[chainBlock].blueCount, candidate, anticoneSize)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool Ghostdag::checkChainBlues(const GhostdagBlockData &data, const uint32_t *bluesBegin, const uint32_t *bluesEnd,
+                               uint32_t candidate, uint32_t &anticoneSize) {
+	for (const uint32_t *blue = bluesBegin; blue != bluesEnd; blue++) {
+		if (isAncestor(*blue, candidate)) {
+			continue;
+		}
+
+		uint32_t blueSize = blueAnticoneSize(*blue, data);
+		candidateBlues.push_back(*blue);
+		candidateSizes.push_back(blueSize);
+		anticoneSize++;
+
+		if (anticoneSize > k || blueSize == k) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint32_t Ghostdag::blueAnticoneSize(uint32_t blue, const GhostdagBlockData &data) const {
+	auto it = std::find(data.anticoneBlocks.begin(), data.anticoneBlocks.end(), blue);
+	if (it != data.anticoneBlocks.end()) {
+		return data.anticoneSizes[it - data.anticoneBlocks.begin()];
+	}
+
+	// The most recent chain block that recorded the blue holds its current size
+	for (uint32_t chainBlock = data.selectedParent; chainBlock != GHOSTDAG_NO_BLOCK;
+	     chainBlock = blocks[chainBlock].selectedParent) {
+		const GhostdagBlock &block = blocks[chainBlock];
+		const uint32_t *begin = anticoneBlocks.data() + block.anticoneOffset;
+		const uint32_t *end = begin + block.anticoneCount;
+		const uint32_t *found = std::find(begin, end, blue);
+		if (found != end) {
+			return anticoneSizes[block.anticoneOffset + (found - begin)];
+		}
+	}
+
+	throw std::logic_error("Blue block is not recorded by any chain block");
+}
+
+bool Ghostdag::precedes(uint32_t first, uint32_t second) {
+	if (first == second) {
+		return false;
+	}
+
+	// Chain blocks go after their mergesets, blue score of chain blocks grows along the chain
+	uint32_t firstChain = mergingChainBlock(first);
+	uint32_t secondChain = mergingChainBlock(second);
+	if (firstChain != secondChain) {
+		return secondChain == GHOSTDAG_NO_BLOCK ||
+		       (firstChain != GHOSTDAG_NO_BLOCK && blocks[firstChain].blueScore < blocks[secondChain].blueScore);
+	}
+	if (first == firstChain || second == secondChain) {
+		return second == secondChain;
+	}
+	return mergesetLess(first, second);
+}
+
+uint32_t Ghostdag::mergingChainBlock(uint32_t blockId) {
+	if (blockId != sink && !isAncestor(blockId, sink)) {
+		return GHOSTDAG_NO_BLOCK;
+	}
+
+	uint32_t chainBlock = sink;
+	for (uint32_t parent = blocks[chainBlock].selectedParent;
+	     parent != GHOSTDAG_NO_BLOCK && (parent == blockId || isAncestor(blockId, parent));
+	     parent = blocks[chainBlock].selectedParent) {
+		chainBlock = parent;
+	}
+	return chainBlock;
+}
+
+uint32_t Ghostdag::computeOrder(std::vector<uint32_t> &order, std::vector<bool> &blue) {
+	auto blockCount = uint32_t(blocks.size());
+	order.clear();
+	order.reserve(blockCount);
+	blue.assign(blockCount, false);
+
+	std::vector<uint32_t> tips;
+	for (uint32_t blockId = 0; blockId < blockCount; blockId++) {
+		if (dag->firstChildReference(blockId) == DAG_NO_REFERENCE) {
+			tips.push_back(blockId);
+		}
+	}
+
+	GhostdagBlockData virtualData;
+	computeData(tips.data(), tips.data() + tips.size(), virtualData);
+
+	std::vector<uint32_t> chain;
+	for (uint32_t chainBlock = virtualData.selectedParent; chainBlock != GHOSTDAG_NO_BLOCK;
+	     chainBlock = blocks[chainBlock].selectedParent) {
+		chain.push_back(chainBlock);
+	}
+
+	// Each chain block is preceded by its mergeset without the selected parent, which is the previous chain block
+	std::vector<uint32_t> mergeset;
+	auto appendMergeset = [&](const uint32_t *begin, const uint32_t *blueEnd, const uint32_t *end) {
+		mergeset.assign(begin, end);
+		for (const uint32_t *blockId = begin + 1; blockId < blueEnd; blockId++) {
+			blue[*blockId] = true;
+		}
+		std::sort(mergeset.begin() + 1, mergeset.end(), [this](uint32_t first, uint32_t second) {
+			return mergesetLess(first, second);
+		});
+		order.insert(order.end(), mergeset.begin() + 1, mergeset.end());
+	};
+
+	for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+		const GhostdagBlock &block = blocks[*it];
+		if (block.selectedParent != GHOSTDAG_NO_BLOCK) {
+			const uint32_t *begin = mergesets.data() + block.mergesetOffset;
+			appendMergeset(begin, begin + block.blueCount, begin + block.blueCount + block.redCount);
+		}
+		blue[*it] = true;
+		order.push_back(*it);
+	}
+
+	if (virtualData.selectedParent != GHOSTDAG_NO_BLOCK) {
+		std::vector<uint32_t> virtualMergeset = virtualData.blues;
+		virtualMergeset.insert(virtualMergeset.end(), virtualData.reds.begin(), virtualData.reds.end());
+		const uint32_t *begin = virtualMergeset.data();
+		appendMergeset(begin, begin + virtualData.blues.size(), begin + virtualMergeset.size());
+	}
+
+	return uint32_t(chain.size());
+}
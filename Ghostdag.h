@@ -0,0 +1,209 @@
+/**
+ * @file Ghostdag.h
+ * @brief Incremental GHOSTDAG, blue set, blue score and selected parent of each block computed when it is mined
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef GHOSTDAG_H
+#define GHOSTDAG_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "BlockDag.h"
+#include "Reachability.h"
+
+const uint32_t GHOSTDAG_NO_BLOCK = UINT32_MAX;
+
+/**
+ * @brief GHOSTDAG data of a block, mergeset and blue anticone sizes are stored in shared arenas
+ */
+class GhostdagBlock {
+public:
+	uint32_t selectedParent;
+	uint32_t blueScore;
+	uint32_t mergesetOffset;    // Blues of mergeset followed by reds
+	uint32_t blueCount;         // Blues of mergeset including the selected parent
+	uint32_t redCount;
+	uint32_t anticoneOffset;    // Blue anticone sizes recorded by this block
+	uint32_t anticoneCount;
+};
+
+/**
+ * @brief GHOSTDAG data of a block that is being added or of the virtual block
+ */
+class GhostdagBlockData {
+public:
+	uint32_t selectedParent = GHOSTDAG_NO_BLOCK;
+	uint32_t blueScore = 0;
+	std::vector<uint32_t> blues;
+	std::vector<uint32_t> reds;
+	std::vector<uint32_t> anticoneBlocks;   // Blue anticone size of anticoneBlocks[i] is anticoneSizes[i]
+	std::vector<uint32_t> anticoneSizes;
+};
+
+/**
+ * @brief Data of a block depend only on its past, so they are computed once when the block is mined and cached.
+ * Mergeset of a new block is the part of its past that is not in the past of its selected parent. Candidates of the
+ * mergeset are colored in topological order, a candidate is blue if its anticone among blues has at most k blocks
+ * and no blue would get more than k blues in its anticone. Anticone of a candidate is collected chain block by chain
+ * block, all blues of a chain block are checked at once and the walk stops at the first chain block in the past of
+ * the candidate. Ancestry is answered by the reachability index, which is extended by each added block.
+ */
+class Ghostdag {
+	const BlockDag *dag = nullptr;
+	uint32_t k = 0;
+
+	std::vector<GhostdagBlock> blocks;
+	std::vector<uint32_t> mergesets;
+	std::vector<uint32_t> anticoneBlocks;
+	std::vector<uint32_t> anticoneSizes;
+
+	ReachabilityIndex reachability;
+	uint32_t sink = GHOSTDAG_NO_BLOCK;     // Block with the highest blue score, selected parent of the virtual block
+
+	// Blocks visited by the mergeset search
+	std::vector<uint32_t> mergesetStamps;
+	uint32_t mergesetStamp = 0;
+
+	// Candidate checks
+	std::vector<uint32_t> candidateBlues;
+	std::vector<uint32_t> candidateSizes;
+	std::vector<uint32_t> mergesetCandidates;
+
+	uint64_t ancestryQueries = 0;
+
+	/**
+	 * @brief Compute GHOSTDAG data of a block with given parents, all parents have to be added
+	 * @param parentsBegin pointer to the first parent
+	 * @param parentsEnd pointer after the last parent
+	 * @param data output
+	 */
+	void computeData(const uint32_t *parentsBegin, const uint32_t *parentsEnd, GhostdagBlockData &data);
+
+	/**
+	 * @brief Blocks in the past of the parents that are not in the past of the selected parent, sorted by blue score
+	 * @param parentsBegin pointer to the first parent
+	 * @param parentsEnd pointer after the last parent
+	 * @param selectedParent selected parent
+	 * @param mergeset output, selected parent is not included
+	 */
+	void computeMergeset(const uint32_t *parentsBegin, const uint32_t *parentsEnd, uint32_t selectedParent,
+	                     std::vector<uint32_t> &mergeset);
+
+	/**
+	 *
+	 * @param data data of the new block
+	 * @param candidate mergeset block
+	 * @param anticoneSize output, number of blues in anticone of the candidate
+	 * @return True if the candidate can be colored blue
+	 */
+	bool checkBlueCandidate(const GhostdagBlockData &data, uint32_t candidate, uint32_t &anticoneSize);
+
+	/**
+	 * @brief Add blues of one chain block that are in the anticone of the candidate
+	 * @param data data of the new block
+	 * @param bluesBegin pointer to the first blue of the chain block
+	 * @param bluesEnd pointer after the last blue of the chain block
+	 * @param candidate mergeset block
+	 * @param anticoneSize number of blues in anticone of the candidate, updated
+	 * @return False if the candidate has to be red
+	 */
+	bool checkChainBlues(const GhostdagBlockData &data, const uint32_t *bluesBegin, const uint32_t *bluesEnd,
+	                     uint32_t candidate, uint32_t &anticoneSize);
+
+	/**
+	 *
+	 * @param blue blue block in the past of the new block
+	 * @param data data of the new block
+	 * @return Number of blues in the anticone of the blue block as seen from the new block
+	 */
+	uint32_t blueAnticoneSize(uint32_t blue, const GhostdagBlockData &data) const;
+
+	/**
+	 *
+	 * @param blockId id of a block
+	 * @return Lowest block of the chain of the sink that has the block in its mergeset or is the block itself,
+	 * GHOSTDAG_NO_BLOCK if the block is merged by the virtual block
+	 */
+	uint32_t mergingChainBlock(uint32_t blockId);
+
+	/**
+	 * @brief Order of blocks in a mergeset, topological because blue score grows along DAG edges
+	 */
+	inline bool mergesetLess(uint32_t first, uint32_t second) const {
+		return blocks[first].blueScore != blocks[second].blueScore ? blocks[first].blueScore < blocks[second].blueScore
+		                                                           : first < second;
+	}
+
+public:
+	/**
+	 *
+	 * @param _dag block DAG, blocks are read from it when they are added
+	 * @param _k maximum anticone size of blue blocks
+	 */
+	void init(const BlockDag *_dag, uint32_t _k);
+
+	/**
+	 * @brief Compute and cache data of a block that was just added to the DAG
+	 * @param blockId id of the block
+	 */
+	void addBlock(uint32_t blockId);
+
+	/**
+	 *
+	 * @param ancestor possible ancestor
+	 * @param block block
+	 * @return True if ancestor is in the past of the block
+	 */
+	inline bool isAncestor(uint32_t ancestor, uint32_t block) {
+		ancestryQueries++;
+		return reachability.isAncestor(ancestor, block);
+	}
+
+	/**
+	 * @brief Compare two blocks in the order of the current virtual block, the chain is walked from the sink, so
+	 * recent blocks are compared fastest
+	 * @param first block
+	 * @param second another block
+	 * @return True if the first block precedes the second one
+	 */
+	bool precedes(uint32_t first, uint32_t second);
+
+	/**
+	 * @brief Order all blocks by the chain of the virtual block that has all blocks without children as parents
+	 * @param order output, block ids in GHOSTDAG order
+	 * @param blue output, color of each block
+	 * @return Number of blocks of the selected chain
+	 */
+	uint32_t computeOrder(std::vector<uint32_t> &order, std::vector<bool> &blue);
+
+	/**
+	 *
+	 * @param blockId id of a block
+	 * @return Cached data of the block
+	 */
+	inline const GhostdagBlock &block(uint32_t blockId) const {
+		return blocks[blockId];
+	}
+
+	/**
+	 *
+	 * @return Number of ancestry queries made so far
+	 */
+	inline uint64_t ancestryQueryCount() const {
+		return ancestryQueries;
+	}
+
+	/**
+	 *
+	 * @return Reachability index over the selected parent tree
+	 */
+	inline const ReachabilityIndex &reachabilityIndex() const {
+		return reachability;
+	}
+};
+
+#endif //GHOSTDAG_H
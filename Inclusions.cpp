@@ -0,0 +1,60 @@
+/**
+ * @file Inclusions.cpp
+ * @brief Online effective throughput, conflicting inclusions of a transaction are resolved by the consensus order
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#include "Inclusions.h"
+
+void InclusionTracker::include(TxTable &txTable, TxHandle handle, uint32_t fee, uint32_t blockId, uint32_t minerId) {
+	if (blockId >= blockMiners.size()) {
+		blockMiners.resize(blockId + 1, 0);
+	}
+	blockMiners[blockId] = minerId;
+	if (minerId >= minerTxs.size()) {
+		minerTxs.resize(minerId + 1, 0);
+		minerFees.resize(minerId + 1, 0);
+	}
+	includedTxs++;
+
+	if (txTable.inclusionBlock(handle) == TX_NOT_INCLUDED) {
+		txTable.setInclusionBlock(handle, blockId);
+		uniqueTxs++;
+		uniqueFees += fee;
+		credit(blockId, fee, 1);
+		return;
+	}
+
+	uint64_t txId = txTable.txId(handle);
+	auto it = conflicts.try_emplace(txId, ConflictState{txTable.inclusionBlock(handle), 0}).first;
+	it->second.pendingCount++;
+	pending.push_back({txId, blockId, fee});
+}
+
+void InclusionTracker::resolve(uint32_t watermark, const std::function<bool(uint32_t, uint32_t)> &precedes) {
+	// Pending inclusions are in the order of block ids
+	while (!pending.empty() && pending.front().blockId < watermark) {
+		PendingInclusion inclusion = pending.front();
+		pending.pop_front();
+
+		auto it = conflicts.find(inclusion.txId);
+		ConflictState &conflict = it->second;
+		if (precedes(inclusion.blockId, conflict.effectiveBlock)) {
+			credit(conflict.effectiveBlock, inclusion.fee, -1);
+			credit(inclusion.blockId, inclusion.fee, 1);
+			conflict.effectiveBlock = inclusion.blockId;
+			reorderedTxs++;
+		}
+		if (--conflict.pendingCount == 0) {
+			conflicts.erase(it);
+		}
+	}
+}
+
+void InclusionTracker::credit(uint32_t blockId, uint32_t fee, int sign) {
+	uint32_t minerId = blockMiners[blockId];
+	minerTxs[minerId] += sign;
+	minerFees[minerId] += int64_t(sign) * fee;
+}
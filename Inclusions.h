@@ -0,0 +1,134 @@
+/**
+ * @file Inclusions.h
+ * @brief Online effective throughput, conflicting inclusions of a transaction are resolved by the consensus order
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef INCLUSIONS_H
+#define INCLUSIONS_H
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include "TxTable.h"
+
+/**
+ * @brief Inclusion of an already included transaction, resolved when the block is received by all miners
+ */
+class PendingInclusion {
+public:
+	uint64_t txId;
+	uint32_t blockId;
+	uint32_t fee;
+};
+
+/**
+ * @brief Effective block of a transaction with pending inclusions
+ */
+class ConflictState {
+public:
+	uint32_t effectiveBlock;
+	uint32_t pendingCount;
+};
+
+/**
+ * @brief The first inclusion of a transaction is effective and its fee goes to the miner of the block. Later
+ * inclusions of the same transaction wait until their block is received by all miners, then the block that comes
+ * first in the current consensus order takes over the transaction. Each inclusion takes O(1). Transaction handle
+ * may be recycled before its pending inclusions are resolved, so the effective block of such transaction is kept by
+ * transaction id until the last one is resolved.
+ */
+class InclusionTracker {
+	std::vector<uint32_t> blockMiners;      // Miner id of each block that includes a transaction
+	std::vector<uint64_t> minerTxs;         // Effective transactions by miner id
+	std::vector<uint64_t> minerFees;        // Fees of effective transactions by miner id
+	std::deque<PendingInclusion> pending;
+	std::unordered_map<uint64_t, ConflictState> conflicts;
+
+	uint64_t includedTxs = 0;
+	uint64_t uniqueTxs = 0;
+	uint64_t uniqueFees = 0;
+	uint64_t reorderedTxs = 0;  // Transactions taken over by a block mined later
+
+	/**
+	 * @brief Move credit of an effective transaction to the miner of a block
+	 * @param blockId block that includes the transaction
+	 * @param fee fee of the transaction
+	 * @param sign 1 to add the credit, -1 to remove it
+	 */
+	void credit(uint32_t blockId, uint32_t fee, int sign);
+
+public:
+	/**
+	 * @brief Record a transaction included in a mined block
+	 * @param txTable transaction table
+	 * @param handle transaction handle
+	 * @param fee fee of the transaction
+	 * @param blockId id of the mined block
+	 * @param minerId id of the miner of the block
+	 */
+	void include(TxTable &txTable, TxHandle handle, uint32_t fee, uint32_t blockId, uint32_t minerId);
+
+	/**
+	 * @brief Resolve pending inclusions of blocks below the watermark
+	 * @param watermark blocks with lower id are received by all miners
+	 * @param precedes consensus order, true if the first block precedes the second one
+	 */
+	void resolve(uint32_t watermark, const std::function<bool(uint32_t, uint32_t)> &precedes);
+
+	/**
+	 *
+	 * @return Number of transactions in all mined blocks
+	 */
+	inline uint64_t includedCount() const {
+		return includedTxs;
+	}
+
+	/**
+	 *
+	 * @return Number of distinct transactions in mined blocks
+	 */
+	inline uint64_t uniqueCount() const {
+		return uniqueTxs;
+	}
+
+	/**
+	 *
+	 * @return Sum of fees of distinct transactions
+	 */
+	inline uint64_t uniqueFeeSum() const {
+		return uniqueFees;
+	}
+
+	/**
+	 *
+	 * @return Number of times a block mined later took over an effective transaction
+	 */
+	inline uint64_t reorderedCount() const {
+		return reorderedTxs;
+	}
+
+	/**
+	 *
+	 * @param minerId id of a miner
+	 * @return Number of transactions effectively included by the miner
+	 */
+	inline uint64_t minerTxCount(uint32_t minerId) const {
+		return minerId < minerTxs.size() ? minerTxs[minerId] : 0;
+	}
+
+	/**
+	 *
+	 * @param minerId id of a miner
+	 * @return Fees of transactions effectively included by the miner
+	 */
+	inline uint64_t minerFeeSum(uint32_t minerId) const {
+		return minerId < minerFees.size() ? minerFees[minerId] : 0;
+	}
+};
+
+#endif //INCLUSIONS_H
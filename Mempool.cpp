@@ -8,7 +8,7 @@
 
 #include "Mempool.h"
 
-HtabItem::HtabItem(std::string &_key, uint64_t _txId, uint32_t _fee) : key(_key), txId(_txId), fee(_fee) {}
+HtabItem::HtabItem(TxHandle _handle, uint32_t _fee) : handle(_handle), fee(_fee) {}
 
 HtabIterator::HtabIterator(std::list<HtabItem>::iterator _iterator, size_t _index) : iterator(_iterator),
                                                                                      index(_index) {}
@@ -18,12 +18,22 @@ void HtabItem::setIterator(
 	multimapIterator = _multimapIterator;
 }
 
-Mempool::Mempool(size_t n) : htabItems(n, std::list<HtabItem>{}), randomMempoolIndexGenerator(0, int(n) - 1) {
+Mempool::Mempool(size_t n, TxTable &_txTable) : txTable(&_txTable), randomMempoolIndexGenerator(0, int(n) - 1) {
 	arrSize = n;
 	itemCount = 0;
 }
 
+void Mempool::allocate() {
+	if (htabItems.empty()) {
+		htabItems.resize(arrSize);
+	}
+}
+
 HtabIterator Mempool::begin() {
+	if (itemCount == 0) {
+		return end();
+	}
+
 	for (size_t i = 0; i < arrSize; i++) {
 		if (!htabItems[i].empty()) {
 			return {htabItems[i].begin(), i};
@@ -43,6 +53,10 @@ size_t Mempool::bucketCount() const {
 }
 
 HtabIterator Mempool::getRandomTransaction(std::mt19937 randomGen) {
+	if (itemCount == 0) {
+		return end();
+	}
+
 	size_t index = randomMempoolIndexGenerator(randomGen);
 
 	size_t max = (arrSize / 2) + 1;
@@ -105,6 +119,7 @@ void Mempool::eraseTransaction(HtabIterator &iterator) {
 		return;
 	}
 
+	txTable->release(iterator.iterator->handle);
 	multimapItems.erase(iterator.iterator->multimapIterator);
 	htabItems[iterator.index].erase(iterator.iterator);
 	itemCount--;
@@ -119,6 +134,7 @@ void Mempool::eraseTransactionsAscending(const uint32_t size) {
 
 		i++;
 
+		txTable->release(it->second.first->handle);
 		htabItems[it->second.second].erase(it->second.first);
 		multimapItems.erase(it++); // Remove and increase iterator
 
@@ -128,6 +144,10 @@ void Mempool::eraseTransactionsAscending(const uint32_t size) {
 
 void Mempool::eraseRandomTransactions(std::mt19937 randomGen, const uint32_t size) {
 	for (int i = 0; i < size; i++) {
+		if (itemCount == 0) {
+			break;
+		}
+
 		// Take random index in hash table
 		size_t index = randomMempoolIndexGenerator(randomGen);
 
@@ -143,6 +163,7 @@ void Mempool::eraseRandomTransactions(std::mt19937 randomGen, const uint32_t siz
 			if (!htabItems[down_idx].empty()) {
 				if (htabItems[down_idx].size() == 1) {
 					// Directly remove element if bucket size == 1
+					txTable->release(htabItems[down_idx].begin()->handle);
 					multimapItems.erase(htabItems[down_idx].begin()->multimapIterator);
 					htabItems[down_idx].pop_front();
 					itemCount--;
@@ -152,6 +173,7 @@ void Mempool::eraseRandomTransactions(std::mt19937 randomGen, const uint32_t siz
 					std::uniform_int_distribution<> bucketIndex(0, int(htabItems[down_idx].size()) - 1);
 					auto it = htabItems[down_idx].begin();
 					std::advance(it, bucketIndex(randomGen));
+					txTable->release(it->handle);
 					multimapItems.erase(it->multimapIterator);
 					htabItems[down_idx].erase(it);
 					itemCount--;
@@ -169,6 +191,7 @@ void Mempool::eraseRandomTransactions(std::mt19937 randomGen, const uint32_t siz
 			if (!htabItems[up_idx].empty()) {
 				if (htabItems[up_idx].size() == 1) {
 					// Directly remove element if bucket size == 1
+					txTable->release(htabItems[up_idx].begin()->handle);
 					multimapItems.erase(htabItems[up_idx].begin()->multimapIterator);
 					htabItems[up_idx].pop_front();
 					itemCount--;
@@ -178,6 +201,7 @@ void Mempool::eraseRandomTransactions(std::mt19937 randomGen, const uint32_t siz
 					std::uniform_int_distribution<> bucketIndex(0, int(htabItems[up_idx].size()) - 1);
 					auto it = htabItems[up_idx].begin();
 					std::advance(it, bucketIndex(randomGen));
+					txTable->release(it->handle);
 					multimapItems.erase(it->multimapIterator);
 					htabItems[up_idx].erase(it);
 					itemCount--;
@@ -191,47 +215,81 @@ void Mempool::eraseRandomTransactions(std::mt19937 randomGen, const uint32_t siz
 	}
 }
 
-HtabIterator Mempool::find(uint32_t minerId, uint64_t txId) {
-	std::string key = std::to_string(minerId).append(".").append(std::to_string(txId));
-
-//	if (key.empty()) {
-//		return end();
-//	}
+HtabIterator Mempool::find(uint32_t minerId, TxHandle handle) {
+	if (itemCount == 0) {
+		return end();
+	}
 
 	// Get index from hash function
-	size_t index = (hashFun(key) % arrSize);
+	size_t index = (hashFun(minerId, handle) % arrSize);
 
 	auto &vectIt = htabItems[index];
 
-	size_t i = 0;
 	for (auto it = vectIt.begin(); it != vectIt.end(); ++it) {
-		if (it->txId == txId) {
+		if (it->handle == handle) {
 			return {it, index};
 		}
-		i++;
 	}
 
 	return end();
 }
 
-size_t Mempool::hashFun(const std::string &key) {
-	return std::hash<std::string>{}(key);
+uint64_t Mempool::missingBytes(uint32_t minerId, const std::vector<Transaction> &transactions,
+                               const TxTable &txTable) {
+
+	batchIndices.resize(transactions.size());
+	for (size_t i = 0; i < transactions.size(); i++) {
+		batchIndices[i] = hashFun(minerId, transactions[i].handle) % arrSize;
+#ifdef __GNUC__
+		__builtin_prefetch(&htabItems[batchIndices[i]]);
+#endif
+	}
+
+	uint64_t missing = 0;
+	for (size_t i = 0; i < transactions.size(); i++) {
+		bool found = false;
+		for (const HtabItem &item: htabItems[batchIndices[i]]) {
+			if (item.handle == transactions[i].handle) {
+				found = true;
+				break;
+			}
+		}
+
+		if (!found) {
+			missing += txTable.vsize(transactions[i].handle);
+		}
+	}
+
+	return missing;
+}
+
+size_t Mempool::hashFun(uint32_t minerId, TxHandle handle) {
+	// Miner id salts the key so miners do not share the same bucket layout (splitmix64 finalizer)
+	uint64_t key = (uint64_t(minerId) << 32) | handle;
+	key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+	return size_t(key ^ (key >> 31));
 }
 
 void Mempool::clear() {
 	for (auto &item: htabItems) {
+		for (HtabItem &htabItem: item) {
+			txTable->release(htabItem.handle);
+		}
 		item.clear();
 	}
 	multimapItems.clear();
 	itemCount = 0;
 }
 
-HtabIterator Mempool::insert(uint32_t minerId, uint64_t txId, uint32_t fee) {
-	std::string key = std::to_string(minerId).append(".").append(std::to_string(txId));
-	size_t index = (hashFun(key) % arrSize);
+HtabIterator Mempool::insert(uint32_t minerId, TxHandle handle, uint32_t fee) {
+	allocate();
+
+	size_t index = (hashFun(minerId, handle) % arrSize);
 
 	// Create new entry
-	htabItems[index].emplace_front(key, txId, fee);
+	txTable->retain(handle);
+	htabItems[index].emplace_front(handle, fee);
 	auto multimapIterator = multimapItems.insert({fee, {htabItems[index].begin(), index}});
 	htabItems[index].begin()->setIterator(multimapIterator);
 
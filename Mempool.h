@@ -15,15 +15,16 @@
 #include <list>
 #include <iterator>
 #include <random>
+#include "TxTable.h"
+#include "Block.h"
 
 class HtabItem {
 public:
-	std::string &key;
-	uint64_t txId;
+	TxHandle handle;
 	uint32_t fee;
 	std::multimap<uint32_t, std::pair<std::list<HtabItem>::iterator, uint32_t>>::iterator multimapIterator;
 
-	HtabItem(std::string &_key, uint64_t _txId, uint32_t _fee);
+	HtabItem(TxHandle _handle, uint32_t _fee);
 
 	void setIterator(
 			std::multimap<uint32_t, std::pair<std::list<HtabItem>::iterator, uint32_t>>::iterator _multimapIterator);
@@ -34,7 +35,7 @@ public:
 	 * @return State if items are equal
 	 */
 	inline bool isEqual(HtabItem *item) const {
-		return txId == item->txId;
+		return handle == item->handle;
 	}
 };
 
@@ -55,7 +56,12 @@ public:
 };
 
 class Mempool {
+	// Buckets are allocated on the first insert, so miners that never store a transaction do not pay for them
 	std::vector<std::list<HtabItem>> htabItems;
+	std::list<HtabItem> invalidBucket;
+
+	// Every stored transaction holds one reference in the table
+	TxTable *txTable;
 	std::multimap<uint32_t, std::pair<std::list<HtabItem>::iterator, uint32_t>> multimapItems;
 
 	std::uniform_int_distribution<> randomMempoolIndexGenerator;
@@ -63,20 +69,29 @@ class Mempool {
 	size_t itemCount;
 	size_t arrSize;
 
+	// Reused buffer of bucket indices for batched lookups
+	std::vector<size_t> batchIndices;
+
 	/**
 	 * @brief Used when item does not exists in hashtable
 	 * @return Invalid element.
 	 */
 	inline HtabIterator end() {
-		return {htabItems[0].end(), SIZE_MAX};
+		return {invalidBucket.end(), SIZE_MAX};
 	}
 
+	/**
+	 * @brief Allocate hashtable buckets if they were not allocated yet
+	 */
+	void allocate();
+
 public:
 	/**
 	 *
 	 * @param n maximum number of transactions that can stored in mempool
+	 * @param _txTable table of live transactions
 	 */
-	Mempool(size_t n);
+	Mempool(size_t n, TxTable &_txTable);
 
 	/**
 	 *
@@ -130,18 +145,29 @@ public:
 
 	/**
 	 *
-	 * @param key string to hash
-	 * @return hash value of key
+	 * @param minerId Id of miner
+	 * @param handle transaction handle
+	 * @return hash value of the key
 	 */
-	static size_t hashFun(const std::string &key);
+	static size_t hashFun(uint32_t minerId, TxHandle handle);
 
 	/**
 	 *
 	 * @param minerId Id of miner
-	 * @param txId transaction id
+	 * @param handle transaction handle
 	 * @return Iterator to item
 	 */
-	HtabIterator find(uint32_t minerId, uint64_t txId);
+	HtabIterator find(uint32_t minerId, TxHandle handle);
+
+	/**
+	 * @brief Batched membership test, bucket indices of all transactions are computed first so the bucket loads
+	 * do not wait for each other
+	 * @param minerId Id of miner
+	 * @param transactions tested transactions
+	 * @param txTable transaction table with sizes of the transactions
+	 * @return Size of transactions that are not stored in mempool in bytes
+	 */
+	uint64_t missingBytes(uint32_t minerId, const std::vector<Transaction> &transactions, const TxTable &txTable);
 
 	/**
 	 * @brief Erase all items in mempool
@@ -151,11 +177,11 @@ public:
 	/**
 	 *
 	 * @param minerId Id of miner
-	 * @param txId transaction id
+	 * @param handle transaction handle
 	 * @param fee transaction fee
 	 * @return Iterator to inserted item
 	 */
-	HtabIterator insert(uint32_t minerId, uint64_t txId, uint32_t fee);
+	HtabIterator insert(uint32_t minerId, TxHandle handle, uint32_t fee);
 };
 
 
@@ -7,25 +7,40 @@
  * @date 2021 - 2022
  */
 
+#include <memory>
+#include <algorithm>
+#include <limits>
+#include <unordered_set>
 #include "Miner.h"
 
-Miner::Miner(double _miningPower, MinerType _type, Simulation &_simulation) : miningPower(_miningPower), type(_type),
-                                                                              simulation(_simulation),
-                                                                              minerId(nextId++),
-                                                                              depth(0),
-                                                                              mempool(simulation.getMpCapacity()),
-                                                                              receivedBlocks(simulation.getBlockCount(),
-                                                                                             false) {
+Miner::Miner(double _miningPower, MinerType _type, Simulation &_simulation) : Miner(nextId++, _miningPower, _type,
+                                                                                    _simulation) {
 }
 
-void Miner::addPeer(Miner &miner, double latency) {
-	peers.emplace_back(miner, latency);
+Miner::Miner(uint32_t _minerId, double _miningPower, MinerType _type, Simulation &_simulation) :
+		miningPower(_miningPower), type(_type), simulation(_simulation), minerId(_minerId), index(minerId), depth(0),
+		mempool(simulation.getMpCapacity(), simulation.getTxTable()) {
+	// Relay stream of each miner is independent of the order in which miners relay blocks
+	relayRandomGen = SplitMix64(SplitMix64((uint64_t(uint32_t(simulation.getSeed())) << 32) | minerId)());
 }
 
 void Miner::mineBlock(uint32_t blockNumber) {
-	depth++;
+	if (simulation.lazyMempoolEnabled()) {
+		materializeMempool();
+	}
+
+	// New block references all tips of the miner's view and it is deeper than all of them
+	std::sort(tips.begin(), tips.end());
+	depth = 1;
+	for (uint32_t parent: tips) {
+		depth = std::max(depth, simulation.getBlock(parent).depth + 1);
+	}
+	simulation.addDagBlock(blockNumber, tips);
+	tips.assign(1, blockNumber);
 
-	receivedBlocks[blockNumber] = true;
+	receivedBlocks.set(blockNumber);
+	requestedBlocks.set(blockNumber);
+	queuedBlocks.set(blockNumber);
 	Block minedBlock{blockNumber, depth, simulation.getBlockSize()};
 
 	// Stop simulation if miner has not enough transaction to fill the block
@@ -34,36 +49,60 @@ void Miner::mineBlock(uint32_t blockNumber) {
 	}
 
 	if (type == HONEST) {
-		for (uint32_t i = 0; i < simulation.getBlockSize(); ++i) {
+		while (minedBlock.transactions.size() < simulation.getBlockSize()) {
+			if (getMempoolFullness() == 0) {
+				simulation.errorOutOfTxsExit(*this);
+			}
 			HtabIterator it = mempool.getRandomTransaction(simulation.getRandomGen());
 
-			uint64_t txId = it.iterator->txId;
+			TxHandle handle = it.iterator->handle;
 			uint32_t fee = it.iterator->fee;
 
-			minedBlock.transactions.push_back({txId, fee});
+			// Transactions of blocks that expired before reaching this miner are only dropped
+			if (simulation.txSettled(handle)) {
+				mempool.eraseTransaction(it);
+				continue;
+			}
+
+			// Block holds its own reference until it reaches all miners
+			minedBlock.transactions.push_back({handle, fee});
+			minedBlock.txBytes += simulation.getTxTable().vsize(handle);
+			simulation.getTxTable().retain(handle);
 
 			// Log mined block
-			simulation.logData(txId, fee, minedBlock.id, depth, minerId);
+			simulation.includeTransaction(handle, fee, minedBlock.id, depth, minerId);
 
 			mempool.eraseTransaction(it);
 		}
 	}
 	else if (type == MALICIOUS) {
-		for (uint32_t i = 0; i < simulation.getBlockSize(); ++i) {
+		while (minedBlock.transactions.size() < simulation.getBlockSize()) {
+			if (getMempoolFullness() == 0) {
+				simulation.errorOutOfTxsExit(*this);
+			}
 			HtabIterator it = mempool.getSortedTransactionDescending();
 
-			uint64_t txId = it.iterator->txId;
+			TxHandle handle = it.iterator->handle;
 			uint32_t fee = it.iterator->fee;
 
-			minedBlock.transactions.push_back({txId, fee});
+			if (simulation.txSettled(handle)) {
+				mempool.eraseTransaction(it);
+				continue;
+			}
+
+			minedBlock.transactions.push_back({handle, fee});
+			minedBlock.txBytes += simulation.getTxTable().vsize(handle);
+			simulation.getTxTable().retain(handle);
 
 			// Log mined block
-			simulation.logData(txId, fee, minedBlock.id, depth, minerId);
+			simulation.includeTransaction(handle, fee, minedBlock.id, depth, minerId);
 
 			mempool.eraseTransaction(it);
 		}
 	}
 
+	minedBlock.txCount = uint32_t(minedBlock.transactions.size());
+
 	lastMinedBlockId++;
 	if (lastMinedBlockId * 100 / simulation.getBlockCount() > simulation.getProgress()) {
 		simulation.incrementProgress();
@@ -75,64 +114,490 @@ void Miner::mineBlock(uint32_t blockNumber) {
 		simulation.logMempoolDataOfAllMiners();
 	}
 
-	broadcastBlock(*this, minedBlock);
+	// Relayed events refer to the stored block instead of copying it
+	const Block &storedBlock = simulation.storeBlock(std::move(minedBlock));
+	simulation.blockArrived(storedBlock, *this);
+	if (simulation.lazyMempoolEnabled()) {
+		simulation.consumeBlock(storedBlock.id);
+	}
+
+	if (simulation.getPropagationMode() == PROPAGATION_FLOOD) {
+		broadcastBlock(*this, storedBlock);
+	}
+	else {
+		simulation.propagateBlock(index, storedBlock);
+	}
 }
 
 void Miner::broadcastBlock(Miner &fromMiner, const Block& block) {
-	for (Peer &peer: peers) {
+	// Relay network overlay is handled in the same pass, receivers keep the earliest arrival over either network
+	for (const Topology *graph: {&simulation.getTopology(), &simulation.getRelayTopology()}) {
+		const Topology &topology = *graph;
+		topology.sampleJitters(index, relayRandomGen, jitters);
+
+		for (uint32_t slot = 0; slot < topology.slotCount(index); slot++) {
+			uint32_t edge = topology.slotEdge(index, slot);
+			if (!topology.edgeActive(index, edge)) {
+				continue;
+			}
 
-		// Do not relay to peer that just sent this block
-		if (&peer.getMiner() == &fromMiner) {
-			continue;
+			Miner &peer = simulation.getMiner(topology.neighbor(edge));
+
+			// Do not relay to peer that just sent this block
+			if (&peer == &fromMiner) {
+				continue;
+			}
+
+			double latency = topology.latency(edge);
+			double jitter = jitters[slot];
+
+			// Only the header is announced, the block is transferred when the peer requests it
+			if (simulation.getBlockRelay() == BLOCK_RELAY_INV) {
+				double peerLatencyTime = simulation.getScheduler().getSimTime() + latency + jitter +
+				                         topology.transmissionDelay(edge, BLOCK_HEADER_SIZE);
+				double bandwidth = topology.bandwidth(edge);
+
+				auto function = [&peer, &block, latency, bandwidth]() {
+					peer.receiveBlockAnnouncement(block, latency, bandwidth);
+				};
+				simulation.getScheduler().schedule(function, peerLatencyTime);
+				continue;
+			}
+
+			simulation.countBlockTransfer();
+
+			if (simulation.compactBlocksEnabled()) {
+				double peerLatencyTime = simulation.getScheduler().getSimTime() + latency + jitter +
+				                         topology.transmissionDelay(edge, block.compactByteSize());
+				double bandwidth = topology.bandwidth(edge);
+
+				auto function = [&peer, &block, latency, bandwidth]() {
+					peer.receiveCompactBlock(block, latency, bandwidth);
+				};
+				simulation.getScheduler().schedule(function, peerLatencyTime);
+				continue;
+			}
+
+			double peerLatencyTime = simulation.getScheduler().getSimTime() + latency + jitter +
+			                         topology.transmissionDelay(edge, block.byteSize());
+
+			auto function = [&peer, &block]() {
+				peer.receiveBlock(block);
+			};
+			simulation.getScheduler().schedule(function, peerLatencyTime);
 		}
+	}
+}
+
+void Miner::receiveBlockAnnouncement(const Block& block, double latency, double bandwidth) {
+	// Block is requested only from the first peer that announced it, miner that left the network drops messages
+	if (requestedBlocks.test(block.id) || !simulation.getTopology().nodeOnline(index)) {
+		return;
+	}
+	requestedBlocks.set(block.id);
+	simulation.countBlockTransfer();
 
-		double jitter = 0;
-		if (peer.getLatency() > 0) {
-			std::uniform_real_distribution<> jitterDelay(peer.getLatency() / BLOCK_PROPAGAITON_JITTER_DIFF_MIN,
-														peer.getLatency() / BLOCK_PROPAGAITON_JITTER_DIFF_MAX);
-			jitter = jitterDelay(simulation.getRandomGen());
+	// Request (getdata) travels to the announcing peer, which sends the block back
+	bool compact = simulation.compactBlocksEnabled();
+	double bytes = compact ? block.compactByteSize() : block.byteSize();
+	double time = simulation.getScheduler().getSimTime() + 2 * latency + (bandwidth > 0 ? bytes / bandwidth : 0);
+
+	auto function = [this, &block, compact, latency, bandwidth]() {
+		if (compact) {
+			this->receiveCompactBlock(block, latency, bandwidth);
+		}
+		else {
+			this->receiveBlock(block);
 		}
+	};
+	simulation.getScheduler().schedule(function, time);
+}
 
-		double peerLatencyTime = simulation.getScheduler().getSimTime() + peer.getLatency() + jitter;
+void Miner::receiveCompactBlock(const Block& block, double latency, double bandwidth) {
+	if (queuedBlocks.test(block.id) || !simulation.getTopology().nodeOnline(index)) {
+		return;
+	}
 
-//		auto function = std::bind(&Miner::receiveBlock, peer.getMiner(), *this, block, peer.getLatency());
-		auto function = [&peer, block]() {
-			peer.getMiner().receiveBlock(block);
-		};
-		simulation.getScheduler().schedule(function, peerLatencyTime);
+	double missingBytes = double(mempool.missingBytes(minerId, block.transactions, simulation.getTxTable()));
+	if (missingBytes == 0) {
+		receiveBlock(block);
+		return;
 	}
+
+	// Missing transactions cost one more round trip (getblocktxn, blocktxn) and their transmission
+	double delay = 2 * latency + (bandwidth > 0 ? missingBytes / bandwidth : 0);
+
+	auto function = [this, &block]() { this->receiveBlock(block); };
+	simulation.getScheduler().schedule(function, simulation.getScheduler().getSimTime() + delay);
 }
 
 void Miner::receiveBlock(const Block& block) {
+	// Blocks missed while offline are synchronized when the miner comes back
+	if (!simulation.getTopology().nodeOnline(index)) {
+		return;
+	}
+
+	if (!simulation.validationEnabled()) {
+		acceptBlock(block);
+		return;
+	}
+
+	// Single server queue, blocks are validated one by one in the order of arrival
+	if (queuedBlocks.test(block.id)) {
+		return;
+	}
+	queuedBlocks.set(block.id);
+
+	double time = simulation.getScheduler().getSimTime();
+	double start = std::max(time, validationCursor);
+	validationCursor = start + simulation.validationTime(block);
+	simulation.countValidation(start - time, validationCursor - time);
+
+	auto function = [this, &block]() { this->acceptBlock(block); };
+	simulation.getScheduler().schedule(function, validationCursor);
+}
+
+void Miner::acceptBlock(const Block& block) {
 	if (block.depth > depth) {
 		depth = block.depth;
 	}
 
 	// Check if miner already processed this block
-	if (!receivedBlocks[block.id]) {
-		receivedBlocks[block.id] = true;
-
-		// Update miners mempool
-		for (Transaction transaction: block.transactions) {
-			HtabIterator htabIterator = mempool.find(minerId, transaction.txId);
-			mempool.eraseTransaction(htabIterator);
+	if (!receivedBlocks.test(block.id)) {
+		receivedBlocks.set(block.id);
+		requestedBlocks.set(block.id);
+		queuedBlocks.set(block.id);
+		updateTips(block.id);
+
+		// Update miners mempool, confirmed transactions are not accepted from gossip anymore
+		if (simulation.lazyMempoolEnabled()) {
+			pendingBlocks.push_back(block.id);
+		}
+		else {
+			for (Transaction transaction: block.transactions) {
+				HtabIterator htabIterator = mempool.find(minerId, transaction.handle);
+				mempool.eraseTransaction(htabIterator);
+				if (simulation.txGossipEnabled()) {
+					markKnownTx(transaction.handle);
+				}
+			}
 		}
-		broadcastBlock(*this, block);
+		// Other propagation modes schedule arrivals to all miners when the block is mined
+		if (simulation.getPropagationMode() == PROPAGATION_FLOOD) {
+			broadcastBlock(*this, block);
+		}
+		simulation.blockArrived(block, *this);
 
 		// Check (approximately) if all blocks were processed by all miners, if yes stop generate new transactions
 		// and finish simulation
 		if (block.id == simulation.getBlockCount() - 1) {
 			minersFinished++;
 
-			if (minersFinished == nextId - 1) {
+			if (minersFinished == simulation.getMinerCount() - 1) {
 				simulation.stopGenerateTransactions();
 			}
 		}
 	}
 }
 
-void Miner::insertTransaction(uint64_t txId, uint32_t fee) {
-	mempool.insert(minerId, txId, fee);
+void Miner::updateTips(uint32_t blockId) {
+	const BlockDag &dag = simulation.getDag();
+
+	for (const uint32_t *parent = dag.parentsBegin(blockId); parent != dag.parentsEnd(blockId); parent++) {
+		auto it = std::find(tips.begin(), tips.end(), *parent);
+		if (it != tips.end()) {
+			*it = tips.back();
+			tips.pop_back();
+		}
+	}
+
+	// Block that arrived after its child is not a tip
+	for (uint32_t reference = dag.firstChildReference(blockId); reference != DAG_NO_REFERENCE;
+	     reference = dag.nextChildReference(reference)) {
+		if (receivedBlocks.test(dag.referenceBlock(reference))) {
+			return;
+		}
+	}
+	tips.push_back(blockId);
+}
+
+void Miner::insertTransaction(TxHandle handle, uint32_t fee) {
+	mempool.insert(minerId, handle, fee);
+
+	// Instant insertion never relays transactions, so it does not track them
+	if (simulation.txGossipEnabled()) {
+		markKnownTx(handle);
+	}
+}
+
+void Miner::markKnownTx(TxHandle handle) {
+	knownTxs.advanceTo(simulation.getHorizonTxId());
+	knownTxs.set(simulation.getTxTable().txId(handle));
+}
+
+void Miner::submitTransaction(TxHandle handle, uint32_t fee) {
+	makeRoom(1);
+	insertTransaction(handle, fee);
+	announceTransaction({handle, fee}, nullptr);
+}
+
+bool Miner::removesRandomly() const {
+	return simulation.honestRandomRemoveEnabled() && type == HONEST;
+}
+
+void Miner::makeRoom(uint32_t txCount) {
+	if (getMempoolFullness() + txCount > simulation.getMpCapacity()) {
+		if (removesRandomly()) {
+			removeTransactionsRandom(txCount);
+		}
+		else {
+			removeTransactionsRationally(txCount);
+		}
+	}
+}
+
+void Miner::materializeMempool() {
+	// Transactions confirmed by blocks received since the last materialization
+	// Pending blocks and unread log entries keep their references, so their handles are never recycled
+	std::unordered_set<TxHandle> confirmedTxs;
+	for (uint32_t blockId: pendingBlocks) {
+		for (const Transaction &transaction: simulation.getBlock(blockId).transactions) {
+			confirmedTxs.insert(transaction.handle);
+		}
+	}
+
+	for (TxHandle confirmedTx: confirmedTxs) {
+		HtabIterator htabIterator = mempool.find(minerId, confirmedTx);
+		mempool.eraseTransaction(htabIterator);
+	}
+
+	// Unconfirmed transactions that arrived since the last materialization
+	std::vector<Transaction> arrived;
+	for (; arrivalLogCursor < simulation.getArrivalLogEnd(); arrivalLogCursor++) {
+		const Transaction &transaction = simulation.getArrivalLogEntry(arrivalLogCursor);
+		if (confirmedTxs.find(transaction.handle) == confirmedTxs.end() && !simulation.txSettled(transaction.handle)) {
+			arrived.push_back(transaction);
+		}
+	}
+
+	// Eviction is applied once to the whole batch, so only transactions that can survive are inserted
+	size_t capacity = simulation.getMpCapacity();
+	if (arrived.size() > capacity) {
+		if (removesRandomly()) {
+			for (size_t i = 0; i < capacity; i++) {
+				std::uniform_int_distribution<size_t> swapIndex(i, arrived.size() - 1);
+				std::swap(arrived[i], arrived[swapIndex(simulation.getRandomGen())]);
+			}
+		}
+		else {
+			std::nth_element(arrived.begin(), arrived.begin() + long(capacity), arrived.end(),
+			                 [](const Transaction &a, const Transaction &b) { return a.fee > b.fee; });
+		}
+		arrived.resize(capacity);
+	}
+
+	for (const Transaction &transaction: arrived) {
+		mempool.insert(minerId, transaction.handle, transaction.fee);
+	}
+
+	if (mempool.size() > capacity) {
+		auto excess = uint32_t(mempool.size() - capacity);
+		if (removesRandomly()) {
+			removeTransactionsRandom(excess);
+		}
+		else {
+			removeTransactionsRationally(excess);
+		}
+	}
+
+	// Mempool holds its own references now, read blocks and log entries can release theirs
+	for (uint32_t blockId: pendingBlocks) {
+		simulation.consumeBlock(blockId);
+	}
+	pendingBlocks.clear();
+	simulation.trimArrivalLog();
+}
+
+void Miner::announceTransaction(const Transaction &transaction, const Miner *fromMiner) {
+	const Topology &topology = simulation.getTopology();
+
+	// Links added to the topology get new slots
+	if (pendingTxs.size() < topology.slotCount(index)) {
+		pendingTxs.resize(topology.slotCount(index));
+	}
+
+	// Queued announcement holds a reference until the receiver processes it
+	for (uint32_t slot = 0; slot < topology.slotCount(index); slot++) {
+		uint32_t edge = topology.slotEdge(index, slot);
+		if (topology.edgeActive(index, edge) && &simulation.getMiner(topology.neighbor(edge)) != fromMiner) {
+			pendingTxs[slot].push_back(transaction);
+			simulation.getTxTable().retain(transaction.handle);
+		}
+	}
+
+	// Announcements are sent on the next trickle, Bitcoin uses exponentially distributed trickle timer
+	if (!trickleScheduled) {
+		trickleScheduled = true;
+
+		std::exponential_distribution<> trickleDelay(1.0 / simulation.getTrickleInterval());
+		double trickleTime = simulation.getScheduler().getSimTime() + trickleDelay(simulation.getRandomGen());
+
+		auto function = [this]() { this->flushInventory(); };
+		simulation.getScheduler().schedule(function, trickleTime);
+	}
+}
+
+void Miner::flushInventory() {
+	trickleScheduled = false;
+
+	const Topology &topology = simulation.getTopology();
+
+	for (uint32_t slot = 0; slot < pendingTxs.size(); slot++) {
+		std::vector<Transaction> &pending = pendingTxs[slot];
+		if (pending.empty()) {
+			continue;
+		}
+
+		// Announcements queued for a link that went down are dropped
+		uint32_t edge = topology.slotEdge(index, slot);
+		if (!topology.edgeActive(index, edge)) {
+			for (const Transaction &transaction: pending) {
+				simulation.getTxTable().release(transaction.handle);
+			}
+			pending.clear();
+			continue;
+		}
+
+		// Single event per link carries the whole batch
+		auto batch = std::make_shared<std::vector<Transaction>>();
+		batch->swap(pending);
+		double arrivalTime = simulation.getScheduler().getSimTime() + topology.latency(edge);
+
+		Miner &peer = simulation.getMiner(topology.neighbor(edge));
+		auto function = [this, &peer, batch]() {
+			peer.receiveTransactions(*this, *batch);
+		};
+		simulation.getScheduler().schedule(function, arrivalTime);
+	}
+}
+
+void Miner::receiveTransactions(Miner &fromMiner, const std::vector<Transaction> &transactions) {
+	TxTable &txTable = simulation.getTxTable();
+	bool online = simulation.getTopology().nodeOnline(index);
+
+	std::vector<Transaction> newTransactions;
+	for (const Transaction &transaction: transactions) {
+		if (!online || knownTxs.test(txTable.txId(transaction.handle))) {
+			continue;
+		}
+
+		// Settled transactions are not accepted, they are only marked to keep the window contiguous
+		if (simulation.txSettled(transaction.handle)) {
+			markKnownTx(transaction.handle);
+		}
+		else {
+			newTransactions.push_back(transaction);
+		}
+	}
+
+	if (!newTransactions.empty()) {
+		makeRoom(uint32_t(newTransactions.size()));
+
+		for (const Transaction &transaction: newTransactions) {
+			insertTransaction(transaction.handle, transaction.fee);
+			announceTransaction(transaction, &fromMiner);
+		}
+	}
+
+	for (const Transaction &transaction: transactions) {
+		txTable.release(transaction.handle);
+	}
+}
+
+void Miner::synchronizeBlocks() {
+	double time = simulation.getScheduler().getSimTime();
+
+	// Blocks below the watermark are already received by all miners
+	for (uint32_t blockId = simulation.getSyncedBlockCount(); blockId < simulation.getStoredBlockCount(); blockId++) {
+		const Block &block = simulation.getBlock(blockId);
+		double bytes = block.byteSize();
+		double download = std::numeric_limits<double>::infinity();
+		bool broadcast = false;
+
+		// Missing block is downloaded once from the peer with the earliest arrival over either network
+		for (const Topology *graph: {&simulation.getTopology(), &simulation.getRelayTopology()}) {
+			const Topology &topology = *graph;
+
+			for (uint32_t slot = 0; slot < topology.slotCount(index) && !broadcast; slot++) {
+				uint32_t edge = topology.slotEdge(index, slot);
+				if (!topology.edgeActive(index, edge)) {
+					continue;
+				}
+
+				Miner &peer = simulation.getMiner(topology.neighbor(edge));
+				double arrival = time + topology.latency(edge) + topology.transmissionDelay(edge, bytes);
+
+				if (!receivedBlocks.test(blockId) && peer.receivedBlocks.test(blockId)) {
+					download = std::min(download, arrival);
+				}
+				else if (receivedBlocks.test(blockId) && !peer.receivedBlocks.test(blockId)) {
+					// Other propagation modes deliver the block to the rest of the network at once
+					if (simulation.getPropagationMode() != PROPAGATION_FLOOD) {
+						broadcast = true;
+						break;
+					}
+					simulation.countBlockTransfer();
+
+					auto function = [&peer, &block]() { peer.receiveBlock(block); };
+					simulation.getScheduler().schedule(function, arrival);
+				}
+			}
+		}
+
+		if (download != std::numeric_limits<double>::infinity()) {
+			simulation.countBlockTransfer();
+
+			auto function = [this, &block]() { this->receiveBlock(block); };
+			simulation.getScheduler().schedule(function, download);
+		}
+
+		if (broadcast) {
+			simulation.propagateBlock(index, block);
+		}
+	}
+}
+
+void Miner::remapPendingTxs(const Topology &previous) {
+	if (pendingTxs.empty()) {
+		return;
+	}
+
+	const Topology &topology = simulation.getTopology();
+	std::vector<std::vector<Transaction>> remapped(topology.slotCount(index));
+
+	for (uint32_t slot = 0; slot < pendingTxs.size(); slot++) {
+		if (pendingTxs[slot].empty()) {
+			continue;
+		}
+
+		// Queue follows the peer, queues of removed links are dropped
+		uint32_t peer = previous.neighbor(previous.slotEdge(index, slot));
+		uint32_t newSlot = 0;
+		while (newSlot < remapped.size() &&
+		       (topology.neighbor(topology.slotEdge(index, newSlot)) != peer || !remapped[newSlot].empty())) {
+			newSlot++;
+		}
+
+		if (newSlot < remapped.size() && !previous.edgeRemoved(previous.slotEdge(index, slot))) {
+			remapped[newSlot].swap(pendingTxs[slot]);
+		}
+		else {
+			for (const Transaction &transaction: pendingTxs[slot]) {
+				simulation.getTxTable().release(transaction.handle);
+			}
+		}
+	}
+	pendingTxs.swap(remapped);
 }
 
 // Sorted remove
@@ -149,6 +614,18 @@ uint32_t Miner::getMinerId() const {
 	return minerId;
 }
 
+uint64_t Miner::getArrivalLogCursor() const {
+	return arrivalLogCursor;
+}
+
+uint32_t Miner::getIndex() const {
+	return index;
+}
+
+void Miner::setIndex(uint32_t _index) {
+	index = _index;
+}
+
 double Miner::getMiningPower() const {
 	return miningPower;
 }
@@ -157,10 +634,6 @@ MinerType Miner::getType() const {
 	return type;
 }
 
-const std::list<Peer> &Miner::getPeers() const {
-	return peers;
-}
-
 size_t Miner::getMempoolFullness() const {
 	return mempool.size();
 }
@@ -11,13 +11,13 @@
 #define MINER_H
 
 #include <vector>
-#include <list>
 #include <random>
 #include "Simulation.h"
 #include "Block.h"
-#include "Peer.h"
+#include "Topology.h"
 #include "Scheduler.h"
 #include "Mempool.h"
+#include "RingBitset.h"
 
 enum MinerType {
 	HONEST,
@@ -26,27 +26,99 @@ enum MinerType {
 
 class Simulation;
 
-class Peer;
-
-const double BLOCK_PROPAGAITON_JITTER_DIFF_MIN = -1000.0;
-const double BLOCK_PROPAGAITON_JITTER_DIFF_MAX = 1000.0;
-
 static uint32_t nextId = 0;
 static uint32_t minersFinished = 0;
 static uint32_t lastMinedBlockId = 0;
 
 class Miner {
 	uint32_t minerId;
+	uint32_t index;     // Position in the topology, differs from miner id when miners are reordered
 	Simulation &simulation;
 	double miningPower;
 	MinerType type;
-	std::list<Peer> peers;
 	Mempool mempool;
-	uint32_t depth;
-	std::vector<bool> receivedBlocks;
+	uint32_t depth;                     // Depth of the deepest block in the miner's view
+	std::vector<uint32_t> tips;         // Received blocks without a received child, parents of the next mined block
+	RingBitset receivedBlocks;          // Window of blocks in flight, blocks below watermark are received
+	RingBitset requestedBlocks;         // Blocks requested from a peer that announced them (inv relay) or received
+	RingBitset queuedBlocks;            // Blocks waiting for validation or received
+	double validationCursor = 0;        // Simulation time when validation of all queued blocks finishes
+	SplitMix64 relayRandomGen;          // Jitter of relayed blocks
+	std::vector<double> jitters;        // Jitter of each edge for the block being relayed
+	RingBitset knownTxs;                // Transactions seen by the miner, used only by gossip
+	bool trickleScheduled = false;
+	std::vector<std::vector<Transaction>> pendingTxs;   // Transactions waiting for the next trickle, per edge slot
+
+	// Lazy mempool state, position in the global arrival log and blocks received since the last materialization
+	uint64_t arrivalLogCursor = 0;
+	std::vector<uint32_t> pendingBlocks;
+
+	/**
+	 * @brief Bring lazy mempool up to date with the arrival log and received blocks
+	 */
+	void materializeMempool();
+
+	/**
+	 *
+	 * @return State if the miner evicts transactions randomly instead of by the lowest fee
+	 */
+	bool removesRandomly() const;
+
+	/**
+	 * @brief Record a transaction seen by gossip, transactions older than the horizon are treated as seen, so the
+	 * window of a miner that missed some announcements (offline, partitioned) does not grow
+	 * @param handle transaction handle
+	 */
+	void markKnownTx(TxHandle handle);
 
 	void broadcastBlock(Miner &fromMiner, const Block& block);
-	void receiveBlock(const Block& block);
+
+	/**
+	 * @brief Validated block is stored, relayed and removed from mempool
+	 * @param block received block
+	 */
+	void acceptBlock(const Block& block);
+
+	/**
+	 * @brief Newly received block replaces its parents in the tip set
+	 * @param blockId id of the received block
+	 */
+	void updateTips(uint32_t blockId);
+
+	/**
+	 * @brief Block header announcement, block is requested if it was not received or requested from another peer
+	 * @param block announced block
+	 * @param latency latency of the link to the announcing peer
+	 * @param bandwidth bandwidth of the link to the announcing peer in bytes per second, 0 for unlimited
+	 */
+	void receiveBlockAnnouncement(const Block& block, double latency, double bandwidth);
+
+	/**
+	 * @brief Compact block arrival, transactions missing in mempool are requested from the sender
+	 * @param block received block
+	 * @param latency latency of the link to the sender
+	 * @param bandwidth bandwidth of the link to the sender in bytes per second, 0 for unlimited
+	 */
+	void receiveCompactBlock(const Block& block, double latency, double bandwidth);
+
+	/**
+	 * @brief Queue transaction announcement to all peers except the one it came from
+	 * @param transaction transaction to relay
+	 * @param fromMiner miner that sent the transaction, nullptr for locally created transaction
+	 */
+	void announceTransaction(const Transaction &transaction, const Miner *fromMiner);
+
+	/**
+	 * @brief Trickle event, send one inventory batch to every peer with pending transactions
+	 */
+	void flushInventory();
+
+	/**
+	 *
+	 * @param fromMiner miner that sent the inventory batch
+	 * @param transactions relayed transactions, each holds a reference that is released here
+	 */
+	void receiveTransactions(Miner &fromMiner, const std::vector<Transaction> &transactions);
 
 public:
 	/**
@@ -58,18 +130,33 @@ public:
 	Miner(double _miningPower, MinerType _type, Simulation &_simulation);
 
 	/**
-	 *
-	 * @param miner peer that is also a miner
-	 * @param latency block propagation delay
+	 * @brief Miner of a network derived from the configuration (coarsened topology) with explicit id
+	 * @param _minerId id of the miner
+	 * @param _miningPower mining power of miner relative to the network
+	 * @param _type Type can be either honest or malicious
+	 * @param _simulation Simulation instance reference
 	 */
-	void addPeer(Miner &miner, double latency);
+	Miner(uint32_t _minerId, double _miningPower, MinerType _type, Simulation &_simulation);
 
 	/**
 	 *
-	 * @param txId transaction id
+	 * @param handle transaction handle
 	 * @param fee transaction fee
 	 */
-	void insertTransaction(uint64_t txId, uint32_t fee);
+	void insertTransaction(TxHandle handle, uint32_t fee);
+
+	/**
+	 * @brief Transaction created at this miner that is relayed to the rest of the network by gossip
+	 * @param handle transaction handle
+	 * @param fee transaction fee
+	 */
+	void submitTransaction(TxHandle handle, uint32_t fee);
+
+	/**
+	 * @brief Remove transactions when there is no room for incoming transactions
+	 * @param txCount number of incoming transactions
+	 */
+	void makeRoom(uint32_t txCount);
 
 	/**
 	 * @brief Sorted remove
@@ -83,12 +170,30 @@ public:
 	 */
 	void removeTransactionsRandom(const uint32_t size);
 
+	/**
+	 * @brief Block arrival event, the block waits in the validation queue of the miner when validation takes time
+	 * @param block received block
+	 */
+	void receiveBlock(const Block& block);
+
 	/**
 	 * @brief Miner generate a block event
 	 * @param blockNumber new block unique number
 	 */
 	void mineBlock(uint32_t blockNumber);
 
+	/**
+	 * @brief Exchange blocks with online peers after the miner or its links come back, blocks that are not received
+	 * by all miners are downloaded from peers that have them and sent to peers that miss them
+	 */
+	void synchronizeBlocks();
+
+	/**
+	 * @brief Move queued transaction announcements to edge slots of compacted topology
+	 * @param previous topology before compaction
+	 */
+	void remapPendingTxs(const Topology &previous);
+
 	/**
 	 *
 	 * @return current miner id
@@ -97,21 +202,33 @@ public:
 
 	/**
 	 *
-	 * @return mining power relative to the network
+	 * @return Index of the miner in the topology
 	 */
-	double getMiningPower() const;
+	uint32_t getIndex() const;
 
 	/**
 	 *
-	 * @return miner type (honest or malicious)
+	 * @return Position of the first arrival log entry that was not added to the lazy mempool
 	 */
-	MinerType getType() const;
+	uint64_t getArrivalLogCursor() const;
+
+	/**
+	 *
+	 * @param _index new index of the miner in the topology
+	 */
+	void setIndex(uint32_t _index);
 
 	/**
 	 *
-	 * @return miners' peers
+	 * @return mining power relative to the network
 	 */
-	const std::list<Peer> &getPeers() const;
+	double getMiningPower() const;
+
+	/**
+	 *
+	 * @return miner type (honest or malicious)
+	 */
+	MinerType getType() const;
 
 	/**
 	 *
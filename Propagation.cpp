@@ -0,0 +1,144 @@
+/**
+ * @file Propagation.cpp
+ * @brief Block propagation models that compute block arrival times without flooding the network with events
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#include <queue>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <stdexcept>
+#include <functional>
+#include "Propagation.h"
+
+void shortestLatencies(const Topology &topology, const Topology &relayTopology, uint32_t source, double blockBytes,
+                       std::vector<double> &latencies, std::mt19937 *randomGen) {
+	typedef std::pair<double, uint32_t> QueueItem;
+
+	latencies.assign(topology.nodeCount(), std::numeric_limits<double>::infinity());
+	latencies[source] = 0;
+
+	std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>> queue;
+	queue.push({0, source});
+
+	while (!queue.empty()) {
+		auto [time, node] = queue.top();
+		queue.pop();
+
+		// Skip outdated queue entries
+		if (time > latencies[node]) {
+			continue;
+		}
+
+		// Edges of both networks are relaxed together, so each node keeps the earliest arrival over either of them
+		for (const Topology *graph: {&topology, &relayTopology}) {
+			for (uint32_t slot = 0; slot < graph->slotCount(node); slot++) {
+				uint32_t edge = graph->slotEdge(node, slot);
+				if (!graph->edgeActive(node, edge)) {
+					continue;
+				}
+
+				double jitter = 0;
+				if (randomGen != nullptr) {
+					jitter = graph->jitter(edge, std::generate_canonical<double, 32>(*randomGen));
+				}
+
+				uint32_t peer = graph->neighbor(edge);
+				double arrival = time + graph->latency(edge) + jitter + graph->transmissionDelay(edge, blockBytes);
+				if (arrival < latencies[peer]) {
+					latencies[peer] = arrival;
+					queue.push({arrival, peer});
+				}
+			}
+		}
+	}
+}
+
+const std::vector<double> &ShortestPathPropagation::computeArrivals(const Topology &topology,
+                                                                   const Topology &relayTopology, uint32_t source,
+                                                                   double blockBytes, std::mt19937 &randomGen) {
+	shortestLatencies(topology, relayTopology, source, blockBytes, arrivals, &randomGen);
+	return arrivals;
+}
+
+void LatencyMatrix::compute(const Topology &topology, const Topology &relayTopology, double blockBytes,
+                            double _resolution, unsigned threadCount) {
+	nodeCount = topology.nodeCount();
+	resolution = _resolution;
+
+	size_t size = size_t(nodeCount) * nodeCount;
+	if (resolution == 0) {
+		latencies.assign(size, 0);
+		fixedLatencies.clear();
+	}
+	else {
+		fixedLatencies.assign(size, 0);
+		latencies.clear();
+	}
+
+	// Tiles are taken dynamically, rows of well connected sources take longer to compute
+	std::atomic<uint32_t> nextTile{0};
+	std::atomic<bool> overflow{false};
+	uint32_t tileCount = (nodeCount + TILE_ROWS - 1) / TILE_ROWS;
+
+	auto worker = [&]() {
+		std::vector<double> row;
+		for (uint32_t tile = nextTile++; tile < tileCount && !overflow; tile = nextTile++) {
+			uint32_t begin = tile * TILE_ROWS;
+			uint32_t end = std::min(begin + TILE_ROWS, nodeCount);
+			if (!computeTile(topology, relayTopology, begin, end, blockBytes, row)) {
+				overflow = true;
+			}
+		}
+	};
+
+	threadCount = std::max(1u, std::min(threadCount, tileCount));
+	std::vector<std::thread> threads;
+	for (unsigned i = 1; i < threadCount; i++) {
+		threads.emplace_back(worker);
+	}
+	worker();
+	for (std::thread &thread: threads) {
+		thread.join();
+	}
+
+	if (overflow) {
+		throw std::runtime_error("Latency matrix: latency exceeds fixed point range, increase resolution");
+	}
+}
+
+bool LatencyMatrix::computeTile(const Topology &topology, const Topology &relayTopology, uint32_t begin, uint32_t end,
+                                double blockBytes, std::vector<double> &row) {
+	for (uint32_t source = begin; source < end; source++) {
+		shortestLatencies(topology, relayTopology, source, blockBytes, row, nullptr);
+
+		size_t offset = size_t(source) * nodeCount;
+		if (resolution == 0) {
+			std::copy(row.begin(), row.end(), latencies.begin() + long(offset));
+			continue;
+		}
+
+		for (uint32_t target = 0; target < nodeCount; target++) {
+			if (row[target] == std::numeric_limits<double>::infinity()) {
+				fixedLatencies[offset + target] = FIXED_UNREACHABLE;
+				continue;
+			}
+
+			double fixed = std::round(row[target] / resolution);
+			if (fixed >= FIXED_UNREACHABLE) {
+				return false;
+			}
+			fixedLatencies[offset + target] = uint16_t(fixed);
+		}
+	}
+
+	return true;
+}
+
+size_t LatencyMatrix::memorySize() const {
+	return latencies.size() * sizeof(double) + fixedLatencies.size() * sizeof(uint16_t);
+}
@@ -0,0 +1,134 @@
+/**
+ * @file Propagation.h
+ * @brief Block propagation models that compute block arrival times without flooding the network with events
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef PROPAGATION_H
+#define PROPAGATION_H
+
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include "Topology.h"
+
+enum PropagationMode {
+	PROPAGATION_FLOOD,          // Every miner relays the block to all peers, O(E) events per block
+	PROPAGATION_SHORTEST_PATH,  // One arrival event per miner at its first arrival time, O(V) events per block
+	PROPAGATION_MATRIX          // Jitter-free arrivals read from precomputed all-pairs latencies, O(V) per block
+};
+
+// Names used in program arguments and outputs, indexed by PropagationMode
+const char *const PROPAGATION_MODE_NAMES[] = {"flood", "shortest_path", "matrix"};
+
+enum BlockRelay {
+	BLOCK_RELAY_PUSH,   // Block is sent to all peers except the sender
+	BLOCK_RELAY_INV     // Header is announced to all peers, block is sent only to peers that request it
+};
+
+// Names used in program arguments and outputs, indexed by BlockRelay
+const char *const BLOCK_RELAY_NAMES[] = {"push", "inv"};
+
+/**
+ * @brief Dijkstra over link latencies from a single source
+ * @param topology network topology
+ * @param relayTopology relay network overlay
+ * @param source index of the source node
+ * @param blockBytes size of the relayed block, adds transmission delay of links with limited bandwidth
+ * @param latencies output, delay of the first arrival to each node, infinity for unreachable nodes
+ * @param randomGen Random generator for link jitter, jitter is not applied if nullptr
+ */
+void shortestLatencies(const Topology &topology, const Topology &relayTopology, uint32_t source, double blockBytes,
+                       std::vector<double> &latencies, std::mt19937 *randomGen);
+
+/**
+ * @brief First arrival of a flooded block is the shortest path over link latency plus jitter. Jitter of each
+ * directed edge is sampled once, when the edge is relaxed, which is the same single sample that the flood model draws
+ * for the edge, so arrival times follow the same distribution as in the flood model.
+ */
+class ShortestPathPropagation {
+	std::vector<double> arrivals;
+
+public:
+	/**
+	 * @brief Run Dijkstra from the mining node
+	 * @param topology network topology
+	 * @param relayTopology relay network overlay
+	 * @param source index of the mining node
+	 * @param blockBytes size of the block
+	 * @param randomGen Random generator for link jitter
+	 * @return Delay of the first arrival to each node, infinity for unreachable nodes
+	 */
+	const std::vector<double> &computeArrivals(const Topology &topology, const Topology &relayTopology,
+	                                           uint32_t source, double blockBytes, std::mt19937 &randomGen);
+};
+
+/**
+ * @brief All-pairs shortest latencies of a static topology without jitter. Row of a source node is stored
+ * contiguously, so delivery of a block is a sequential read of a single row. Rows are computed in tiles of
+ * consecutive sources that worker threads take one by one. Latencies are stored either in full precision or as
+ * 16-bit fixed point multiples of a given resolution, which takes a quarter of the memory.
+ */
+class LatencyMatrix {
+	static const uint32_t TILE_ROWS = 32;
+	static const uint16_t FIXED_UNREACHABLE = UINT16_MAX;
+
+	uint32_t nodeCount = 0;
+	double resolution = 0;              // Seconds per fixed point unit, 0 for full precision
+	std::vector<double> latencies;
+	std::vector<uint16_t> fixedLatencies;
+
+	/**
+	 * @brief Compute and store rows of sources in interval <begin, end)
+	 * @param topology network topology
+	 * @param relayTopology relay network overlay
+	 * @param begin first source
+	 * @param end source after the last one
+	 * @param blockBytes size of a block
+	 * @param row buffer for a single row
+	 * @return False if some latency does not fit to fixed point
+	 */
+	bool computeTile(const Topology &topology, const Topology &relayTopology, uint32_t begin, uint32_t end,
+	                 double blockBytes, std::vector<double> &row);
+
+public:
+	/**
+	 *
+	 * @param topology network topology
+	 * @param relayTopology relay network overlay
+	 * @param blockBytes size of a block, all blocks have the same number of transactions
+	 * @param _resolution seconds per fixed point unit, 0 stores latencies in full precision
+	 * @param threadCount number of worker threads
+	 * @throw std::runtime_error if some latency does not fit to fixed point with given resolution
+	 */
+	void compute(const Topology &topology, const Topology &relayTopology, double blockBytes, double _resolution,
+	             unsigned threadCount);
+
+	/**
+	 *
+	 * @param source source node
+	 * @param target target node
+	 * @return Shortest latency between nodes in seconds, infinity for unreachable node
+	 */
+	inline double latency(uint32_t source, uint32_t target) const {
+		size_t index = size_t(source) * nodeCount + target;
+		if (resolution == 0) {
+			return latencies[index];
+		}
+
+		uint16_t fixed = fixedLatencies[index];
+		return fixed == FIXED_UNREACHABLE ? std::numeric_limits<double>::infinity() : fixed * resolution;
+	}
+
+	/**
+	 *
+	 * @return Number of bytes used by the stored latencies
+	 */
+	size_t memorySize() const;
+};
+
+#endif //PROPAGATION_H
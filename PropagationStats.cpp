@@ -0,0 +1,88 @@
+/**
+ * @file PropagationStats.cpp
+ * @brief Online statistics of block propagation, times at which blocks reach fractions of miners and hash power
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "PropagationStats.h"
+
+// Percentiles of propagation delays written to metadata
+const size_t PROPAGATION_PERCENTILE_COUNT = 3;
+const double PROPAGATION_PERCENTILES[PROPAGATION_PERCENTILE_COUNT] = {0.5, 0.9, 0.99};
+const char *const PROPAGATION_PERCENTILE_NAMES[PROPAGATION_PERCENTILE_COUNT] = {"p50", "p90", "p99"};
+
+void PropagationStats::init(uint32_t minerCount, double totalPower, uint32_t blockCount) {
+	blocks.assign(blockCount, BlockPropagation{});
+
+	for (size_t i = 0; i < PROPAGATION_FRACTION_COUNT; i++) {
+		minerThresholds[i] = std::max(uint32_t(1), uint32_t(std::ceil(PROPAGATION_FRACTIONS[i] * minerCount)));
+		powerThresholds[i] = PROPAGATION_FRACTIONS[i] * totalPower - PROPAGATION_POWER_EPS;
+	}
+}
+
+void PropagationStats::writeCsv(std::ostream &output, uint32_t minedBlocks) const {
+	output << "BlockID,MinerID";
+	for (const char *name: PROPAGATION_FRACTION_NAMES) {
+		output << ",Miners" << name;
+	}
+	for (const char *name: PROPAGATION_FRACTION_NAMES) {
+		output << ",Power" << name;
+	}
+	output << std::endl;
+
+	for (uint32_t id = 0; id < minedBlocks; id++) {
+		const BlockPropagation &block = blocks[id];
+		output << id << "," << block.minerId;
+		for (size_t i = 0; i < PROPAGATION_FRACTION_COUNT; i++) {
+			output << ",";
+			if (i < block.minersReached) {
+				output << block.minerDelays[i];
+			}
+		}
+		for (size_t i = 0; i < PROPAGATION_FRACTION_COUNT; i++) {
+			output << ",";
+			if (i < block.powerReached) {
+				output << block.powerDelays[i];
+			}
+		}
+		output << "\n";
+	}
+}
+
+void PropagationStats::writeSummary(std::ostream &output, uint32_t minedBlocks) const {
+	std::vector<float> delays;
+	uint32_t incompleteBlocks = 0;
+
+	for (bool power: {false, true}) {
+		for (size_t i = 0; i < PROPAGATION_FRACTION_COUNT; i++) {
+			delays.clear();
+			for (uint32_t id = 0; id < minedBlocks; id++) {
+				const BlockPropagation &block = blocks[id];
+				if (i < (power ? block.powerReached : block.minersReached)) {
+					delays.push_back(power ? block.powerDelays[i] : block.minerDelays[i]);
+				}
+			}
+			if (!power && i == PROPAGATION_FRACTION_COUNT - 1) {
+				incompleteBlocks = minedBlocks - uint32_t(delays.size());
+			}
+
+			// Percentiles of blocks that reached the fraction, nearest rank
+			for (size_t p = 0; p < PROPAGATION_PERCENTILE_COUNT; p++) {
+				output << "propagation_" << (power ? "power" : "miners") << PROPAGATION_FRACTION_NAMES[i] << "_"
+				       << PROPAGATION_PERCENTILE_NAMES[p] << "=";
+				if (!delays.empty()) {
+					auto rank = size_t(std::ceil(PROPAGATION_PERCENTILES[p] * double(delays.size()))) - 1;
+					std::nth_element(delays.begin(), delays.begin() + long(rank), delays.end());
+					output << delays[rank];
+				}
+				output << std::endl;
+			}
+		}
+	}
+
+	output << "propagation_incomplete_blocks=" << incompleteBlocks << std::endl;
+}
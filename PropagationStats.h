@@ -0,0 +1,96 @@
+/**
+ * @file PropagationStats.h
+ * @brief Online statistics of block propagation, times at which blocks reach fractions of miners and hash power
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef PROPAGATIONSTATS_H
+#define PROPAGATIONSTATS_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+// Fractions of miners (and of hash power) at which propagation delay of a block is recorded
+const size_t PROPAGATION_FRACTION_COUNT = 3;
+const double PROPAGATION_FRACTIONS[PROPAGATION_FRACTION_COUNT] = {0.5, 0.9, 1.0};
+const char *const PROPAGATION_FRACTION_NAMES[PROPAGATION_FRACTION_COUNT] = {"50", "90", "100"};
+
+// Hash power of miners does not sum exactly to the total because of floating point error
+const double PROPAGATION_POWER_EPS = 0.000001;
+
+/**
+ * @brief Propagation state of a single block, delays are in seconds since the block was mined, negative until reached
+ */
+class BlockPropagation {
+public:
+	double minedTime = 0;
+	double power = 0;
+	uint32_t minerId = 0;
+	uint8_t minersReached = 0;  // Number of reached miner fractions
+	uint8_t powerReached = 0;   // Number of reached hash power fractions
+	float minerDelays[PROPAGATION_FRACTION_COUNT] = {-1, -1, -1};
+	float powerDelays[PROPAGATION_FRACTION_COUNT] = {-1, -1, -1};
+};
+
+/**
+ * @brief Each arrival only compares the arrival count and accumulated hash power with the next unreached fraction
+ */
+class PropagationStats {
+	std::vector<BlockPropagation> blocks;
+	uint32_t minerThresholds[PROPAGATION_FRACTION_COUNT] = {};
+	double powerThresholds[PROPAGATION_FRACTION_COUNT] = {};
+
+public:
+	/**
+	 *
+	 * @param minerCount number of miners
+	 * @param totalPower mining power of all miners
+	 * @param blockCount number of blocks to be simulated
+	 */
+	void init(uint32_t minerCount, double totalPower, uint32_t blockCount);
+
+	/**
+	 * @brief Record arrival of a block to a miner, the first arrival is the miner that mined it
+	 * @param blockId id of the block
+	 * @param minerId id of the miner
+	 * @param arrivals number of miners that have the block including this one
+	 * @param miningPower mining power of the miner
+	 * @param time simulation time of the arrival
+	 */
+	inline void blockArrived(uint32_t blockId, uint32_t minerId, uint32_t arrivals, double miningPower, double time) {
+		BlockPropagation &block = blocks[blockId];
+		if (arrivals == 1) {
+			block.minedTime = time;
+			block.minerId = minerId;
+		}
+		block.power += miningPower;
+
+		auto delay = float(time - block.minedTime);
+		while (block.minersReached < PROPAGATION_FRACTION_COUNT && arrivals >= minerThresholds[block.minersReached]) {
+			block.minerDelays[block.minersReached++] = delay;
+		}
+		while (block.powerReached < PROPAGATION_FRACTION_COUNT && block.power >= powerThresholds[block.powerReached]) {
+			block.powerDelays[block.powerReached++] = delay;
+		}
+	}
+
+	/**
+	 * @brief Write one csv row per mined block, fractions that were not reached are left empty
+	 * @param output output stream
+	 * @param minedBlocks number of mined blocks
+	 */
+	void writeCsv(std::ostream &output, uint32_t minedBlocks) const;
+
+	/**
+	 * @brief Write percentiles of propagation delays over blocks as metadata key=value lines
+	 * @param output output stream
+	 * @param minedBlocks number of mined blocks
+	 */
+	void writeSummary(std::ostream &output, uint32_t minedBlocks) const;
+};
+
+#endif //PROPAGATIONSTATS_H
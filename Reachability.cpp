@@ -0,0 +1,187 @@
+/**
+ * @file Reachability.cpp
+ * @brief Reachability index of the block DAG, interval labels of the selected parent tree and future covering sets
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include "Reachability.h"
+
+ReachabilityIndex::ReachabilityIndex() {
+	intervalStarts.push_back(1);
+	intervalEnds.push_back(UINT64_MAX - 1);
+	treeParents.push_back(REACHABILITY_NO_NODE);
+	firstChildren.push_back(REACHABILITY_NO_NODE);
+	lastChildren.push_back(REACHABILITY_NO_NODE);
+	nextSiblings.push_back(REACHABILITY_NO_NODE);
+	subtreeSizes.push_back(0);
+}
+
+void ReachabilityIndex::addBlock(uint32_t blockId, uint32_t selectedParent, const uint32_t *mergesetBegin,
+                                 const uint32_t *mergesetEnd) {
+	auto node = uint32_t(intervalStarts.size());
+	if (blockId + 1 != node) {
+		throw std::logic_error("Blocks have to be added to the reachability index in the order of their ids");
+	}
+
+	uint32_t parent = selectedParent == REACHABILITY_NO_NODE ? 0 : selectedParent + 1;
+	if (freeStart(parent) > intervalEnds[parent]) {
+		reindex(parent);
+	}
+
+	// The new child leaves at most REACHABILITY_SLACK of the free space to its later siblings
+	uint64_t start = freeStart(parent);
+	uint64_t freeSize = intervalEnds[parent] - start + 1;
+	uint64_t size = freeSize - std::min(freeSize / 2, REACHABILITY_SLACK);
+
+	intervalStarts.push_back(start);
+	intervalEnds.push_back(start + size - 1);
+	treeParents.push_back(parent);
+	firstChildren.push_back(REACHABILITY_NO_NODE);
+	lastChildren.push_back(REACHABILITY_NO_NODE);
+	nextSiblings.push_back(REACHABILITY_NO_NODE);
+	subtreeSizes.push_back(0);
+	futureCoveringSets.emplace_back();
+
+	if (lastChildren[parent] == REACHABILITY_NO_NODE) {
+		firstChildren[parent] = node;
+	} else {
+		nextSiblings[lastChildren[parent]] = node;
+	}
+	lastChildren[parent] = node;
+
+	// Blocks of the mergeset reach the new block outside their subtrees
+	for (const uint32_t *merged = mergesetBegin; merged != mergesetEnd; merged++) {
+		std::vector<uint32_t> &coveringSet = futureCoveringSets[*merged];
+		auto it = std::upper_bound(coveringSet.begin(), coveringSet.end(), start, [this](uint64_t value, uint32_t block) {
+			return value < intervalStarts[block + 1];
+		});
+		if (it != coveringSet.begin() && treeContains(*std::prev(it) + 1, node)) {
+			continue;
+		}
+		coveringSet.insert(it, blockId);
+	}
+}
+
+bool ReachabilityIndex::isAncestor(uint32_t ancestor, uint32_t block) const {
+	if (ancestor == block) {
+		return false;
+	}
+
+	uint32_t node = block + 1;
+	if (treeContains(ancestor + 1, node)) {
+		return true;
+	}
+
+	// Intervals of a covering set are disjoint, only the last one starting before the block can contain it
+	const std::vector<uint32_t> &coveringSet = futureCoveringSets[ancestor];
+	auto it = std::upper_bound(coveringSet.begin(), coveringSet.end(), intervalStarts[node],
+	                           [this](uint64_t value, uint32_t covering) {
+		                           return value < intervalStarts[covering + 1];
+	                           });
+	return it != coveringSet.begin() && treeContains(*std::prev(it) + 1, node);
+}
+
+void ReachabilityIndex::computeSubtreeSizes(uint32_t node) {
+	searchNodes.clear();
+	searchNodes.push_back(node);
+	for (size_t i = 0; i < searchNodes.size(); i++) {
+		subtreeSizes[searchNodes[i]] = 1;
+		for (uint32_t child = firstChildren[searchNodes[i]]; child != REACHABILITY_NO_NODE;
+		     child = nextSiblings[child]) {
+			searchNodes.push_back(child);
+		}
+	}
+
+	// Children are always after their parent in the search order
+	for (size_t i = searchNodes.size() - 1; i > 0; i--) {
+		subtreeSizes[treeParents[searchNodes[i]]] += subtreeSizes[searchNodes[i]];
+	}
+}
+
+void ReachabilityIndex::reindex(uint32_t node) {
+	reindexes++;
+
+	// Climb until the interval holds the subtree with the new child twice and leaves enough free space
+	computeSubtreeSizes(node);
+	uint32_t root = node;
+	while (root != 0 &&
+	       intervalEnds[root] - intervalStarts[root] + 1 < 2 * (uint64_t(subtreeSizes[root]) + 1) +
+	                                                       2 * REACHABILITY_SLACK) {
+		uint32_t parent = treeParents[root];
+		uint32_t size = 1;
+		for (uint32_t child = firstChildren[parent]; child != REACHABILITY_NO_NODE; child = nextSiblings[child]) {
+			if (child != root) {
+				computeSubtreeSizes(child);
+			}
+			size += subtreeSizes[child];
+		}
+		subtreeSizes[parent] = size;
+		root = parent;
+	}
+	reindexedNodes += subtreeSizes[root];
+
+	pathNodes.clear();
+	for (uint32_t pathNode = node; pathNode != root; pathNode = treeParents[pathNode]) {
+		pathNodes.push_back(pathNode);
+	}
+	pathNodes.push_back(root);
+	std::reverse(pathNodes.begin(), pathNodes.end());
+
+	// Nodes on the path pass the space down, the node that gets the new child keeps it free
+	searchNodes.clear();
+	for (size_t i = 0; i < pathNodes.size(); i++) {
+		uint32_t hot = i + 1 < pathNodes.size() ? pathNodes[i + 1] : REACHABILITY_NO_NODE;
+		assignChildIntervals(pathNodes[i], hot, false);
+		for (uint32_t child = firstChildren[pathNodes[i]]; child != REACHABILITY_NO_NODE;
+		     child = nextSiblings[child]) {
+			if (child != hot) {
+				searchNodes.push_back(child);
+			}
+		}
+	}
+
+	// Other subtrees favor their largest child
+	while (!searchNodes.empty()) {
+		uint32_t current = searchNodes.back();
+		searchNodes.pop_back();
+
+		uint32_t hot = firstChildren[current];
+		for (uint32_t child = firstChildren[current]; child != REACHABILITY_NO_NODE; child = nextSiblings[child]) {
+			if (subtreeSizes[child] > subtreeSizes[hot]) {
+				hot = child;
+			}
+			searchNodes.push_back(child);
+		}
+		assignChildIntervals(current, hot, true);
+	}
+}
+
+void ReachabilityIndex::assignChildIntervals(uint32_t node, uint32_t hot, bool keepFree) {
+	if (firstChildren[node] == REACHABILITY_NO_NODE) {
+		return;
+	}
+
+	uint64_t children = 0;
+	uint64_t required = 0;
+	for (uint32_t child = firstChildren[node]; child != REACHABILITY_NO_NODE; child = nextSiblings[child]) {
+		children++;
+		required += subtreeSizes[child];
+	}
+
+	uint64_t extra = intervalEnds[node] - intervalStarts[node] - required;
+	uint64_t share = std::min(REACHABILITY_SLACK, extra / (4 * children));
+	uint64_t reserve = keepFree ? std::min(REACHABILITY_SLACK, extra / 4) : 0;
+	uint64_t hotShare = extra - share * (children - 1) - reserve;
+
+	uint64_t start = intervalStarts[node] + 1;
+	for (uint32_t child = firstChildren[node]; child != REACHABILITY_NO_NODE; child = nextSiblings[child]) {
+		uint64_t size = subtreeSizes[child] + (child == hot ? hotShare : share);
+		intervalStarts[child] = start;
+		intervalEnds[child] = start + size - 1;
+		start += size;
+	}
+}
@@ -0,0 +1,126 @@
+/**
+ * @file Reachability.h
+ * @brief Reachability index of the block DAG, interval labels of the selected parent tree and future covering sets
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef REACHABILITY_H
+#define REACHABILITY_H
+
+#include <vector>
+#include <cstdint>
+
+const uint32_t REACHABILITY_NO_NODE = UINT32_MAX;
+
+// Free space kept by a tree node for later children, a chain of selected parents consumes this much per block
+const uint64_t REACHABILITY_SLACK = 1 << 12;
+
+/**
+ * @brief Blocks form a tree by their selected parents, each tree node gets an interval that contains the intervals of
+ * all its descendants, so tree ancestry is a comparison of interval bounds. A block that is in the future of block a
+ * but not in its subtree is in the subtree of a block that has a in its mergeset. Such blocks are the future covering
+ * set of a, kept sorted by interval, so DAG ancestry is one binary search. When a node has no free space for a new
+ * child, subtree of the closest ancestor with enough space is relabeled and most of the space goes to the path to
+ * the new child. Node 0 is the root of blocks without parents, block b is node b + 1.
+ */
+class ReachabilityIndex {
+	std::vector<uint64_t> intervalStarts;
+	std::vector<uint64_t> intervalEnds;
+	std::vector<uint32_t> treeParents;
+	std::vector<uint32_t> firstChildren;
+	std::vector<uint32_t> lastChildren;
+	std::vector<uint32_t> nextSiblings;     // Children are linked in the order of their intervals
+	std::vector<std::vector<uint32_t>> futureCoveringSets;  // Block ids indexed by block id
+
+	// Subtree sizes are valid only inside the subtree that is being relabeled
+	std::vector<uint32_t> subtreeSizes;
+	std::vector<uint32_t> searchNodes;
+	std::vector<uint32_t> pathNodes;
+
+	uint64_t reindexes = 0;
+	uint64_t reindexedNodes = 0;
+
+	/**
+	 *
+	 * @param ancestor tree node
+	 * @param node tree node
+	 * @return True if the interval of ancestor contains the interval of node, also for the same node
+	 */
+	inline bool treeContains(uint32_t ancestor, uint32_t node) const {
+		return intervalStarts[ancestor] <= intervalStarts[node] && intervalEnds[node] <= intervalEnds[ancestor];
+	}
+
+	/**
+	 *
+	 * @param node tree node
+	 * @return First value of the interval that is not used by children
+	 */
+	inline uint64_t freeStart(uint32_t node) const {
+		return lastChildren[node] == REACHABILITY_NO_NODE ? intervalStarts[node] + 1
+		                                                  : intervalEnds[lastChildren[node]] + 1;
+	}
+
+	/**
+	 * @brief Count nodes of a subtree into subtreeSizes
+	 * @param node root of the subtree
+	 */
+	void computeSubtreeSizes(uint32_t node);
+
+	/**
+	 * @brief Relabel subtree of the closest ancestor with enough space, so that the node gets free space
+	 * @param node tree node without free space
+	 */
+	void reindex(uint32_t node);
+
+	/**
+	 * @brief Split interval of a node among its children, each child gets at least its subtree size
+	 * @param node tree node with relabeled interval
+	 * @param hot child that gets the remaining space, REACHABILITY_NO_NODE to leave it free for a new child
+	 * @param keepFree whether the node keeps part of the space for later children
+	 */
+	void assignChildIntervals(uint32_t node, uint32_t hot, bool keepFree);
+
+public:
+	/**
+	 * @brief Create the root of blocks without parents
+	 */
+	ReachabilityIndex();
+
+	/**
+	 * @brief Append a block, blocks are added in the order of their ids
+	 * @param blockId id of the block
+	 * @param selectedParent parent of the block in the tree, REACHABILITY_NO_NODE for blocks without parents
+	 * @param mergesetBegin pointer to the first block of the mergeset without the selected parent
+	 * @param mergesetEnd pointer after the last block of the mergeset
+	 */
+	void addBlock(uint32_t blockId, uint32_t selectedParent, const uint32_t *mergesetBegin,
+	              const uint32_t *mergesetEnd);
+
+	/**
+	 *
+	 * @param ancestor possible ancestor
+	 * @param block block
+	 * @return True if ancestor is in the past of the block
+	 */
+	bool isAncestor(uint32_t ancestor, uint32_t block) const;
+
+	/**
+	 *
+	 * @return Number of relabeled subtrees
+	 */
+	inline uint64_t reindexCount() const {
+		return reindexes;
+	}
+
+	/**
+	 *
+	 * @return Number of nodes in all relabeled subtrees
+	 */
+	inline uint64_t reindexedNodeCount() const {
+		return reindexedNodes;
+	}
+};
+
+#endif //REACHABILITY_H
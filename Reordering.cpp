@@ -0,0 +1,169 @@
+/**
+ * @file Reordering.cpp
+ * @brief Relabel miners so that neighbors in the topology are stored close to each other in memory
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#include <numeric>
+#include <algorithm>
+#include "Reordering.h"
+
+/**
+ * @brief Breadth-first order of all components, each component starts at the first unvisited node of starts
+ * @param topology network topology
+ * @param starts candidate start nodes in order of preference
+ * @param byDegree visit neighbors with lower degree first
+ * @return Nodes in order of visit
+ */
+static std::vector<uint32_t> breadthFirstOrder(const Topology &topology, const std::vector<uint32_t> &starts,
+                                               bool byDegree) {
+	std::vector<uint32_t> order;
+	order.reserve(topology.nodeCount());
+	std::vector<bool> visited(topology.nodeCount(), false);
+	std::vector<uint32_t> neighbors;
+
+	for (uint32_t start: starts) {
+		if (visited[start]) {
+			continue;
+		}
+
+		// Order itself is the BFS queue
+		visited[start] = true;
+		order.push_back(start);
+		for (size_t head = order.size() - 1; head < order.size(); head++) {
+			uint32_t node = order[head];
+
+			neighbors.clear();
+			for (uint32_t edge = topology.edgesBegin(node); edge < topology.edgesEnd(node); edge++) {
+				if (!visited[topology.neighbor(edge)]) {
+					visited[topology.neighbor(edge)] = true;
+					neighbors.push_back(topology.neighbor(edge));
+				}
+			}
+
+			if (byDegree) {
+				std::stable_sort(neighbors.begin(), neighbors.end(), [&topology](uint32_t a, uint32_t b) {
+					return topology.degree(a) < topology.degree(b);
+				});
+			}
+			order.insert(order.end(), neighbors.begin(), neighbors.end());
+		}
+	}
+
+	return order;
+}
+
+/**
+ * @brief Asynchronous label propagation, each node takes the most frequent label of its neighbors
+ * @param topology network topology
+ * @return Community label of each node
+ */
+static std::vector<uint32_t> propagateLabels(const Topology &topology) {
+	const int MAX_ROUNDS = 20;
+
+	std::vector<uint32_t> labels(topology.nodeCount());
+	std::iota(labels.begin(), labels.end(), 0);
+	std::vector<uint32_t> neighborLabels;
+
+	for (int round = 0; round < MAX_ROUNDS; round++) {
+		bool changed = false;
+
+		for (uint32_t node = 0; node < topology.nodeCount(); node++) {
+			if (topology.degree(node) == 0) {
+				continue;
+			}
+
+			neighborLabels.clear();
+			for (uint32_t edge = topology.edgesBegin(node); edge < topology.edgesEnd(node); edge++) {
+				neighborLabels.push_back(labels[topology.neighbor(edge)]);
+			}
+			std::sort(neighborLabels.begin(), neighborLabels.end());
+
+			// Most frequent label, ties are broken by the current label and then by the lowest label
+			uint32_t best = labels[node];
+			size_t bestCount = 0;
+			for (size_t i = 0; i < neighborLabels.size();) {
+				size_t j = i;
+				while (j < neighborLabels.size() && neighborLabels[j] == neighborLabels[i]) {
+					j++;
+				}
+				if (j - i > bestCount || (j - i == bestCount && neighborLabels[i] == labels[node])) {
+					best = neighborLabels[i];
+					bestCount = j - i;
+				}
+				i = j;
+			}
+
+			if (best != labels[node]) {
+				labels[node] = best;
+				changed = true;
+			}
+		}
+
+		if (!changed) {
+			break;
+		}
+	}
+
+	return labels;
+}
+
+std::vector<uint32_t> computeNodeOrder(const Topology &topology, ReorderMode mode) {
+	uint32_t nodeCount = topology.nodeCount();
+	std::vector<uint32_t> starts(nodeCount);
+	std::iota(starts.begin(), starts.end(), 0);
+
+	if (mode == REORDER_NONE) {
+		return starts;
+	}
+
+	if (mode == REORDER_BFS) {
+		return breadthFirstOrder(topology, starts, false);
+	}
+
+	if (mode == REORDER_RCM) {
+		// Peripheral nodes have low degree, components start from them
+		std::stable_sort(starts.begin(), starts.end(), [&topology](uint32_t a, uint32_t b) {
+			return topology.degree(a) < topology.degree(b);
+		});
+		std::vector<uint32_t> order = breadthFirstOrder(topology, starts, true);
+		std::reverse(order.begin(), order.end());
+		return order;
+	}
+
+	// Communities are laid out in order of their first visit by BFS and members keep the BFS order, so communities
+	// that are connected to each other stay close as in the dendrogram order of Rabbit order
+	std::vector<uint32_t> labels = propagateLabels(topology);
+	std::vector<uint32_t> order = breadthFirstOrder(topology, starts, false);
+
+	std::vector<uint32_t> communityRank(nodeCount, UINT32_MAX);
+	uint32_t nextRank = 0;
+	for (uint32_t node: order) {
+		if (communityRank[labels[node]] == UINT32_MAX) {
+			communityRank[labels[node]] = nextRank++;
+		}
+	}
+
+	std::stable_sort(order.begin(), order.end(), [&labels, &communityRank](uint32_t a, uint32_t b) {
+		return communityRank[labels[a]] < communityRank[labels[b]];
+	});
+	return order;
+}
+
+double meanEdgeSpan(const Topology &topology) {
+	if (topology.edgeCount() == 0) {
+		return 0;
+	}
+
+	double totalSpan = 0;
+	for (uint32_t node = 0; node < topology.nodeCount(); node++) {
+		for (uint32_t edge = topology.edgesBegin(node); edge < topology.edgesEnd(node); edge++) {
+			uint32_t peer = topology.neighbor(edge);
+			totalSpan += peer > node ? peer - node : node - peer;
+		}
+	}
+
+	return totalSpan / double(topology.edgeCount());
+}
@@ -0,0 +1,41 @@
+/**
+ * @file Reordering.h
+ * @brief Relabel miners so that neighbors in the topology are stored close to each other in memory
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef REORDERING_H
+#define REORDERING_H
+
+#include <vector>
+#include <cstdint>
+#include "Topology.h"
+
+enum ReorderMode {
+	REORDER_NONE,       // Configuration order
+	REORDER_BFS,        // Breadth-first search order
+	REORDER_RCM,        // Reverse Cuthill-McKee, BFS from a low degree node visiting low degree neighbors first
+	REORDER_COMMUNITY   // Communities found by label propagation are stored contiguously
+};
+
+// Names used in program arguments and outputs, indexed by ReorderMode
+const char *const REORDER_MODE_NAMES[] = {"none", "bfs", "rcm", "community"};
+
+/**
+ *
+ * @param topology network topology in configuration order
+ * @param mode reordering algorithm
+ * @return Original index of the node at each new position
+ */
+std::vector<uint32_t> computeNodeOrder(const Topology &topology, ReorderMode mode);
+
+/**
+ * @brief Locality of a layout, relay of a block touches miners that are on average this far apart in memory
+ * @param topology network topology
+ * @return Mean distance of indices of edge endpoints
+ */
+double meanEdgeSpan(const Topology &topology);
+
+#endif //REORDERING_H
@@ -0,0 +1,86 @@
+/**
+ * @file RingBitset.cpp
+ * @brief Sliding window set of dense ids stored as a ring of bits above a low watermark
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#include <algorithm>
+#include "RingBitset.h"
+
+// Initial window, 64 ids
+const uint64_t RING_BITSET_INITIAL_WORDS = 1;
+
+RingBitset::RingBitset() : words(RING_BITSET_INITIAL_WORDS, 0), low(0), mask(RING_BITSET_INITIAL_WORDS * 64 - 1) {
+}
+
+void RingBitset::grow(uint64_t id) {
+	uint64_t newCapacity = mask + 1;
+	while (id - low >= newCapacity) {
+		newCapacity *= 2;
+	}
+
+	// Positions depend on capacity, so set ids have to be copied to their new positions
+	std::vector<uint64_t> oldWords(newCapacity / 64, 0);
+	oldWords.swap(words);
+	uint64_t oldMask = mask;
+	mask = newCapacity - 1;
+
+	for (uint64_t i = low; i <= low + oldMask; i++) {
+		uint64_t oldPos = i & oldMask;
+		if ((oldWords[oldPos >> 6] >> (oldPos & 63)) & 1) {
+			uint64_t pos = i & mask;
+			words[pos >> 6] |= uint64_t(1) << (pos & 63);
+		}
+	}
+}
+
+void RingBitset::advance() {
+	while (bit(low)) {
+		clearBit(low);
+		low++;
+	}
+}
+
+void RingBitset::set(uint64_t id) {
+	if (id < low) {
+		return;
+	}
+
+	if (id - low > mask) {
+		grow(id);
+	}
+
+	uint64_t pos = id & mask;
+	words[pos >> 6] |= uint64_t(1) << (pos & 63);
+
+	if (id == low) {
+		advance();
+	}
+}
+
+void RingBitset::advanceTo(uint64_t id) {
+	if (id <= low) {
+		return;
+	}
+
+	if (id - low > mask) {
+		std::fill(words.begin(), words.end(), 0);
+		low = id;
+	}
+	else {
+		for (; low < id; low++) {
+			clearBit(low);
+		}
+	}
+	advance();
+}
+
+uint64_t RingBitset::lowWatermark() const {
+	return low;
+}
+
+uint64_t RingBitset::capacity() const {
+	return mask + 1;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file RingBitset.h
+ * @brief Sliding window set of dense ids stored as a ring of bits above a low watermark
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef RINGBITSET_H
+#define RINGBITSET_H
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief All ids below the low watermark are members of the set. The watermark follows the longest contiguous prefix
+ * of set ids, so memory depends only on the span of ids that are currently in flight.
+ */
+class RingBitset {
+	std::vector<uint64_t> words;
+	uint64_t low;
+	uint64_t mask;  // Capacity in bits - 1, capacity is always power of two
+
+	/**
+	 * @brief Double the capacity until id fits into the window
+	 * @param id id that has to be stored
+	 */
+	void grow(uint64_t id);
+
+	/**
+	 * @brief Move the low watermark over the contiguous prefix of set ids
+	 */
+	void advance();
+
+	inline bool bit(uint64_t id) const {
+		uint64_t pos = id & mask;
+		return (words[pos >> 6] >> (pos & 63)) & 1;
+	}
+
+	inline void clearBit(uint64_t id) {
+		uint64_t pos = id & mask;
+		words[pos >> 6] &= ~(uint64_t(1) << (pos & 63));
+	}
+
+public:
+	RingBitset();
+
+	/**
+	 *
+	 * @param id id to test
+	 * @return State if id is member of the set
+	 */
+	inline bool test(uint64_t id) const {
+		if (id < low) {
+			return true;
+		}
+		if (id - low > mask) {
+			return false;
+		}
+		return bit(id);
+	}
+
+	/**
+	 *
+	 * @param id id to insert into the set
+	 */
+	void set(uint64_t id);
+
+	/**
+	 * @brief Make all ids below id members of the set, ids that were never set are skipped
+	 * @param id new low watermark if it is above the current one
+	 */
+	void advanceTo(uint64_t id);
+
+	/**
+	 *
+	 * @return Lowest id that may not be member of the set
+	 */
+	uint64_t lowWatermark() const;
+
+	/**
+	 *
+	 * @return Number of bits currently allocated for the window
+	 */
+	uint64_t capacity() const;
+};
+
+#endif //RINGBITSET_H
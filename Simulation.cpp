@@ -7,11 +7,11 @@
  * @date 2021 - 2022
  */
 
+#include <limits>
+#include <thread>
 #include "Simulation.h"
 
-Simulation::Simulation() : txGenCountDistribution(int(minTxGenCount), int(maxTxGenCount)),
-                           txGenTimeDistribution(int(minTxGenTime), int(maxTxGenTime)),
-                           feeGenDistribution(1.0) {
+Simulation::Simulation() : feeGenDistribution(1.0) {
 }
 
 void Simulation::runSimulation() {
@@ -19,24 +19,82 @@ void Simulation::runSimulation() {
 	randomGen.seed(seed);
 
 	// Setup simulation from configuration
+	std::vector<Link> links;
+	std::vector<Link> relayLinks;
 	try {
-		miners = ConfigParser{}.parseConfig(*this);
+		if (topologySpec.empty()) {
+			miners = ConfigParser{}.parseConfig(*this, links, relayLinks, topologyEvents);
+		}
+		else {
+			TopologyGenerator generator(topologySpec);
+			miners = generator.generate(*this, links);
+			topologyName = generator.name();
+		}
+	} catch (std::exception &e) {
+		std::cerr << e.what() << std::endl;
+		std::exit(EXIT_FAILURE);
+	}
+
+	// Topology is built once, relay then only reads contiguous arrays
+	topology = Topology(uint32_t(miners.size()), links);
+	relayTopology = Topology(uint32_t(miners.size()), relayLinks);
+	if (coarsenThreshold > 0) {
+		if (!topologyEvents.empty()) {
+			std::cerr << "Coarsening cannot be combined with topology events" << std::endl;
+			std::exit(EXIT_FAILURE);
+		}
+		coarsenMiners(links, relayLinks);
+	}
+	if (reorderMode != REORDER_NONE) {
+		reorderMiners(links, relayLinks);
+	}
+
+	// Static topology without jitter has fixed latencies between all miners
+	if (propagationMode == PROPAGATION_MATRIX) {
+		if (dynamicTopology()) {
+			std::cerr << "Latency matrix propagation requires a static topology" << std::endl;
+			std::exit(EXIT_FAILURE);
+		}
+
+		try {
+			double blockBytes = BLOCK_HEADER_SIZE + double(blockSize) * txVsize;
+			latencyMatrix.compute(topology, relayTopology, blockBytes, matrixResolution,
+			                      std::thread::hardware_concurrency());
+		} catch (std::exception &e) {
+			std::cerr << e.what() << std::endl;
+			std::exit(EXIT_FAILURE);
+		}
+	}
+
+	// Prepare transaction generation distributions
+	try {
+		createArrivalProcess();
 	} catch (std::exception &e) {
 		std::cerr << e.what() << std::endl;
 		std::exit(EXIT_FAILURE);
 	}
+	feeGenDistribution = std::exponential_distribution(1.0);
 
 	prepareOutput();
 	printSimulationStart();
 	startProgress();
 
-	// Prepare transaction generation distributions
-	txGenCountDistribution = std::uniform_int_distribution<>(int(minTxGenCount), int(maxTxGenCount));
-	txGenTimeDistribution = std::uniform_int_distribution<>(int(minTxGenTime), int(maxTxGenTime));
-	feeGenDistribution = std::exponential_distribution(1.0);
+	blockArrivals.assign(blocks, 0);
+	if (lazyMempool) {
+		blockConsumers.assign(blocks, 0);
+	}
+
+	double totalPower = 0;
+	for (const Miner &miner: miners) {
+		totalPower += miner.getMiningPower();
+	}
+	propagationStats.init(uint32_t(miners.size()), totalPower, blocks);
+	ghostdag.init(&dag, ghostdagK);
+	spectre.init(&dag, &ghostdag.reachabilityIndex());
 
 	// Schedule miners block generations
 	scheduleBlockGenerations();
+	scheduleTopologyEvents();
 
 	// Start generating transactions
 	generateInitialTransactions();
@@ -48,8 +106,8 @@ void Simulation::runSimulation() {
 void Simulation::scheduleBlockGenerations() {
 	// Schedule events for each that will be mined by miner with probability of his mining power
 	std::vector<double> mineProbabilities;
-	for (auto &miner: miners) {
-		mineProbabilities.push_back(miner.getMiningPower());
+	for (uint32_t id = 0; id < miners.size(); id++) {
+		mineProbabilities.push_back(miners[minerIndex(id)].getMiningPower());
 	}
 
 	std::discrete_distribution<> minerBlockFindDistribution(mineProbabilities.begin(), mineProbabilities.end());
@@ -60,55 +118,373 @@ void Simulation::scheduleBlockGenerations() {
 
 	double time = 0.0;
 	for (uint32_t i = 0; i < blocks; i++) {
-		size_t minerIndex = minerBlockFindDistribution(randomGen);
-		blockOwners.insert({i, minerIndex});
+		size_t minerId = minerBlockFindDistribution(randomGen);
+		blockOwners.insert({i, minerId});
 
 		double timeDelta = blockTimeGenerationDistribution(randomGen) * lambda;
 		double timeFound = time + timeDelta;
 
 //		auto function = std::bind(&Miner::mineBlock, miners[minerIndex], i);
-		auto function = [this, minerIndex, i]() { this->miners[minerIndex].mineBlock(i); };
+		Miner &miner = miners[minerIndex(uint32_t(minerId))];
+		auto function = [&miner, i]() { miner.mineBlock(i); };
 		scheduler.schedule(function, timeFound);
 		time = timeFound;
 	}
+
+	// Changed topology can keep the last block away from some miners until the end
+	if (dynamicTopology()) {
+		scheduler.schedule([this]() { this->stopGenerateTransactions(); }, time);
+	}
+}
+
+void Simulation::scheduleTopologyEvents() {
+	for (const TopologyEvent &event: topologyEvents) {
+		auto function = [this, &event]() { this->applyTopologyEvent(event); };
+		scheduler.schedule(function, event.time);
+	}
+
+	if (churnRate > 0) {
+		std::exponential_distribution<> churnDelay(churnRate);
+		scheduler.schedule([this]() { this->churnMiner(); }, churnDelay(randomGen));
+	}
+
+	if (linkFailureRate > 0) {
+		std::exponential_distribution<> failureDelay(linkFailureRate);
+		scheduler.schedule([this]() { this->failLink(); }, failureDelay(randomGen));
+	}
+}
+
+void Simulation::applyTopologyEvent(const TopologyEvent &event) {
+	appliedTopologyEvents++;
+
+	switch (event.type) {
+		case EVENT_LINK_DOWN:
+			topology.removeLink(minerIndex(event.link.miner1), minerIndex(event.link.miner2));
+			break;
+		case EVENT_LINK_UP: {
+			uint32_t miner1 = minerIndex(event.link.miner1);
+			uint32_t miner2 = minerIndex(event.link.miner2);
+			bool restored = event.hasLatency ? topology.addLink({miner1, miner2, event.link.latency,
+			                                                     event.link.bandwidth})
+			                                 : topology.restoreLink(miner1, miner2);
+			if (restored) {
+				miners[miner1].synchronizeBlocks();
+			}
+			break;
+		}
+		case EVENT_NODE_DOWN:
+			setMinerOnline(minerIndex(event.miners[0]), false);
+			break;
+		case EVENT_NODE_UP:
+			setMinerOnline(minerIndex(event.miners[0]), true);
+			break;
+		case EVENT_PARTITION: {
+			std::vector<bool> inGroup(miners.size(), false);
+			for (uint32_t id: event.miners) {
+				inGroup[minerIndex(id)] = true;
+			}
+
+			// Links of both networks crossing the group boundary are removed until the partition heals
+			std::vector<std::pair<uint32_t, uint32_t>> cutLinks;
+			std::vector<std::pair<uint32_t, uint32_t>> cutRelayLinks;
+			cutGroupLinks(topology, event.miners, inGroup, cutLinks);
+			cutGroupLinks(relayTopology, event.miners, inGroup, cutRelayLinks);
+
+			auto function = [this, cutLinks, cutRelayLinks]() { this->restoreLinks(cutLinks, cutRelayLinks); };
+			scheduler.schedule(function, scheduler.getSimTime() + event.duration);
+			break;
+		}
+	}
+
+	compactTopology();
+}
+
+void Simulation::setMinerOnline(uint32_t index, bool online) {
+	topology.setNodeOnline(index, online);
+	relayTopology.setNodeOnline(index, online);
+
+	if (online) {
+		miners[index].synchronizeBlocks();
+	}
+}
+
+void Simulation::cutGroupLinks(Topology &graph, const std::vector<uint32_t> &groupMiners,
+                               const std::vector<bool> &inGroup, std::vector<std::pair<uint32_t, uint32_t>> &cutLinks) {
+	for (uint32_t id: groupMiners) {
+		uint32_t node = minerIndex(id);
+		for (uint32_t slot = 0; slot < graph.slotCount(node); slot++) {
+			uint32_t edge = graph.slotEdge(node, slot);
+			uint32_t peer = graph.neighbor(edge);
+			if (!inGroup[peer] && !graph.edgeRemoved(edge)) {
+				cutLinks.emplace_back(node, peer);
+			}
+		}
+	}
+	for (auto [node, peer]: cutLinks) {
+		graph.removeLink(node, peer);
+	}
+}
+
+void Simulation::restoreLinks(const std::vector<std::pair<uint32_t, uint32_t>> &links,
+                              const std::vector<std::pair<uint32_t, uint32_t>> &relayLinks) {
+	for (auto [node, peer]: links) {
+		topology.restoreLink(node, peer);
+	}
+	for (auto [node, peer]: relayLinks) {
+		relayTopology.restoreLink(node, peer);
+	}
+	for (auto [node, peer]: links) {
+		miners[node].synchronizeBlocks();
+	}
+	for (auto [node, peer]: relayLinks) {
+		miners[node].synchronizeBlocks();
+	}
+	compactTopology();
+}
+
+void Simulation::compactTopology() {
+	// Relay network carries no queued announcements, its edge slots are used only during a relay
+	if (relayTopology.needsCompaction()) {
+		relayTopology.compact();
+	}
+
+	if (!topology.needsCompaction()) {
+		return;
+	}
+	topologyCompactions++;
+
+	// Queued transaction announcements are indexed by edge slots that change with compaction
+	if (!txGossip) {
+		topology.compact();
+		return;
+	}
+
+	Topology previous = topology;
+	topology.compact();
+	for (Miner &miner: miners) {
+		miner.remapPendingTxs(previous);
+	}
+}
+
+void Simulation::churnMiner() {
+	if (stopGenerateTransactionsFlag) {
+		return;
+	}
+
+	// Departure of a miner that is already offline is skipped
+	std::uniform_int_distribution<uint32_t> minerDistribution(0, uint32_t(miners.size() - 1));
+	uint32_t index = minerIndex(minerDistribution(randomGen));
+	if (topology.nodeOnline(index)) {
+		appliedTopologyEvents++;
+		setMinerOnline(index, false);
+
+		std::exponential_distribution<> downtime(1.0 / churnDowntime);
+		auto function = [this, index]() {
+			this->appliedTopologyEvents++;
+			this->setMinerOnline(index, true);
+		};
+		scheduler.schedule(function, scheduler.getSimTime() + downtime(randomGen));
+	}
+
+	std::exponential_distribution<> churnDelay(churnRate);
+	scheduler.schedule([this]() { this->churnMiner(); }, scheduler.getSimTime() + churnDelay(randomGen));
+}
+
+void Simulation::failLink() {
+	if (stopGenerateTransactionsFlag) {
+		return;
+	}
+
+	// Random edge slot of a random miner, removed links and miners without links are skipped
+	std::uniform_int_distribution<uint32_t> minerDistribution(0, uint32_t(miners.size() - 1));
+	uint32_t node = minerIndex(minerDistribution(randomGen));
+	if (topology.slotCount(node) > 0) {
+		std::uniform_int_distribution<uint32_t> slotDistribution(0, topology.slotCount(node) - 1);
+		uint32_t peer = topology.neighbor(topology.slotEdge(node, slotDistribution(randomGen)));
+
+		if (topology.removeLink(node, peer)) {
+			appliedTopologyEvents++;
+
+			std::exponential_distribution<> downtime(1.0 / linkDowntime);
+			auto function = [this, node, peer]() {
+				this->appliedTopologyEvents++;
+				this->restoreLinks({{node, peer}}, {});
+			};
+			scheduler.schedule(function, scheduler.getSimTime() + downtime(randomGen));
+			compactTopology();
+		}
+	}
+
+	std::exponential_distribution<> failureDelay(linkFailureRate);
+	scheduler.schedule([this]() { this->failLink(); }, scheduler.getSimTime() + failureDelay(randomGen));
+}
+
+void Simulation::coarsenMiners(std::vector<Link> &links, std::vector<Link> &relayLinks) {
+	originalMinerCount = uint32_t(miners.size());
+	originalLinkCount = links.size();
+
+	// Malicious miners and miners of the relay network are always kept
+	std::vector<bool> candidates(miners.size(), false);
+	for (uint32_t i = 0; i < miners.size(); i++) {
+		candidates[i] = miners[i].getMiningPower() < coarsenThreshold && miners[i].getType() == HONEST;
+	}
+	for (const Link &link: relayLinks) {
+		candidates[link.miner1] = false;
+		candidates[link.miner2] = false;
+	}
+
+	double blockBytes = BLOCK_HEADER_SIZE + double(blockSize) * txVsize;
+	CoarseNetwork network = coarsenTopology(topology, candidates, blockBytes);
+
+	std::vector<double> miningPowers(network.retained.size(), 0);
+	for (uint32_t i = 0; i < miners.size(); i++) {
+		miningPowers[network.owners[i]] += miners[i].getMiningPower();
+	}
+
+	std::vector<Miner> coarseMiners;
+	coarseMiners.reserve(network.retained.size());
+	for (uint32_t i = 0; i < network.retained.size(); i++) {
+		coarseMiners.emplace_back(i, miningPowers[i], miners[network.retained[i]].getType(), *this);
+	}
+
+	for (Link &link: relayLinks) {
+		link.miner1 = network.owners[link.miner1];
+		link.miner2 = network.owners[link.miner2];
+	}
+
+	Topology coarseTopology(uint32_t(coarseMiners.size()), network.links);
+	Topology coarseRelayTopology(uint32_t(coarseMiners.size()), relayLinks);
+	coarseningError = measureCoarseningError(topology, relayTopology, coarseTopology, coarseRelayTopology,
+	                                         network.retained, blockBytes);
+
+	miners.swap(coarseMiners);
+	links.swap(network.links);
+	coarsenedMinerIds.swap(network.retained);
+	topology = std::move(coarseTopology);
+	relayTopology = std::move(coarseRelayTopology);
+}
+
+void Simulation::reorderMiners(std::vector<Link> &links, std::vector<Link> &relayLinks) {
+	std::vector<uint32_t> order = computeNodeOrder(topology, reorderMode);
+	edgeSpanBefore = meanEdgeSpan(topology);
+
+	minerIndices.assign(miners.size(), 0);
+	for (uint32_t i = 0; i < order.size(); i++) {
+		minerIndices[order[i]] = i;
+	}
+
+	std::vector<Miner> reordered;
+	reordered.reserve(miners.size());
+	for (uint32_t i = 0; i < order.size(); i++) {
+		reordered.push_back(std::move(miners[order[i]]));
+		reordered.back().setIndex(i);
+	}
+	miners.swap(reordered);
+
+	// Links are renumbered, edges of each miner keep their order, so relay order does not change
+	for (std::vector<Link> *linkList: {&links, &relayLinks}) {
+		for (Link &link: *linkList) {
+			link.miner1 = minerIndices[link.miner1];
+			link.miner2 = minerIndices[link.miner2];
+		}
+	}
+	topology = Topology(uint32_t(miners.size()), links);
+	relayTopology = Topology(uint32_t(miners.size()), relayLinks);
+	edgeSpanAfter = meanEdgeSpan(topology);
+}
+
+void Simulation::createArrivalProcess() {
+	switch (txArrivalType) {
+		case ARRIVAL_POISSON:
+			arrivalProcess = std::make_unique<PoissonArrivalProcess>(txRate, txBatchInterval);
+			break;
+		case ARRIVAL_BURSTY:
+			arrivalProcess = std::make_unique<BurstyArrivalProcess>(txRate, txBurstFactor, txBatchInterval,
+			                                                        txBurstEnter, txBurstExit);
+			break;
+		case ARRIVAL_DIURNAL:
+			arrivalProcess = std::make_unique<DiurnalArrivalProcess>(txRate, txDiurnalAmplitude, txDiurnalPeriod,
+			                                                         txBatchInterval);
+			break;
+		case ARRIVAL_TRACE:
+			arrivalProcess = std::make_unique<TraceArrivalProcess>(txTracePath, txBatchInterval, txTraceTimeScale,
+			                                                       txTraceLoop);
+			break;
+		case ARRIVAL_UNIFORM:
+		default:
+			arrivalProcess = std::make_unique<UniformArrivalProcess>(minTxGenCount, maxTxGenCount, minTxGenTime,
+			                                                         maxTxGenTime);
+			break;
+	}
 }
 
 void Simulation::generateInitialTransactions() {
 	for (int i = 0; i < initTxCount; i++) {
 		double fee = feeGenDistribution(randomGen) * txGenerationLambda;
+		TxHandle handle = txTable.acquire(txId, txVsize);
 
-		for (auto &miner: miners) {
-			miner.insertTransaction(txId, static_cast<uint32_t>(fee));
+		if (lazyMempool) {
+			// Arrival log keeps the reference from acquire
+			arrivalLog.push_back({handle, static_cast<uint32_t>(fee)});
+		}
+		else {
+			for (auto &miner: miners) {
+				miner.insertTransaction(handle, static_cast<uint32_t>(fee));
+			}
+			txTable.release(handle);
 		}
 		txId++;
 	}
 }
 
 void Simulation::generateTransactions() {
-	uint32_t txCount = txGenCountDistribution(randomGen);
-	uint32_t txWaitTime = txGenTimeDistribution(randomGen);
+	ArrivalBatch batch = arrivalProcess->nextBatch(scheduler.getSimTime(), randomGen);
+
+	// Transactions above mempool capacity would be evicted by the same batch, recorded batches can be that large
+	uint32_t txCount = std::min(batch.txCount, mpCapacity);
+	droppedTxs += batch.txCount - txCount;
+
+	// With gossip, each transaction appears at a random miner and it is relayed over the topology
+	std::uniform_int_distribution<size_t> originDistribution(0, miners.size() - 1);
+	if (txGossip) {
+		double time = scheduler.getSimTime();
+		txBatchStarts.emplace_back(time, txId);
+		while (txBatchStarts.front().first + blockHorizon <= time) {
+			horizonTxId = txBatchStarts.front().second;
+			txBatchStarts.pop_front();
+		}
+	}
 
-	// Generate txCount transactions
+	// Generate txCount transactions, recorded transactions carry their own fee and size
 	for (uint32_t i = 0; i < txCount; i++) {
-		double fee = feeGenDistribution(randomGen) * txGenerationLambda;
+		double fee = batch.records != nullptr ? batch.records[i].fee
+		                                      : feeGenDistribution(randomGen) * txGenerationLambda;
+		uint32_t vsize = batch.records != nullptr && batch.records[i].vsize > 0 ? batch.records[i].vsize : txVsize;
+
+		TxHandle handle = txTable.acquire(txId, vsize);
 
-		for (auto &miner: miners) {
-			if (miner.getMempoolFullness() + txCount > mpCapacity) {
-				if (honestRandomRemove && miner.getType() == HONEST) {
-					miner.removeTransactionsRandom(txCount);
-				}
-				else {
-					miner.removeTransactionsRationally(txCount);
-				}
+		if (txGossip) {
+			miners[minerIndex(uint32_t(originDistribution(randomGen)))].submitTransaction(handle, static_cast<uint32_t>(fee));
+			txTable.release(handle);
+		}
+		else if (lazyMempool) {
+			arrivalLog.push_back({handle, static_cast<uint32_t>(fee)});
+		}
+		else {
+			// Miners in order of ids, random eviction draws from the shared generator
+			for (uint32_t id = 0; id < miners.size(); id++) {
+				Miner &miner = miners[minerIndex(id)];
+				miner.makeRoom(txCount);
+				miner.insertTransaction(handle, static_cast<uint32_t>(fee));
 			}
-			miner.insertTransaction(txId, static_cast<uint32_t>(fee));
+			txTable.release(handle);
 		}
 		txId++;
 	}
 
 	if (!stopGenerateTransactionsFlag) {
-		// Plan in (currentTime + txWaitTime) next generation
-		double nextGenerationTime = scheduler.getSimTime() + txWaitTime;
+		// Plan in (currentTime + waitTime) next generation
+		double nextGenerationTime = scheduler.getSimTime() + batch.waitTime;
 
 //		auto function = []() { &Simulation::generateTransactions; };
 		auto function = [this]() { this->generateTransactions(); };
@@ -121,7 +497,10 @@ void Simulation::prepareOutput() {
 
 	// Get config filename from config path
 	size_t config_filename_pos = this->configPath.find_last_of('/');
-	if (config_filename_pos == std::string::npos) {
+	if (!topologyName.empty()) {
+		configFilename = topologyName;
+	}
+	else if (config_filename_pos == std::string::npos) {
 		configFilename = this->configPath;
 	}
 	else {
@@ -183,29 +562,47 @@ void Simulation::prepareOutput() {
 	// outputs/metadata_{CFG}_{RUN_ID}.data
 	std::string metadataFilenamePath = "outputs/metadata_";
 
+	// outputs/propagation_{CFG}_{RUN_ID}.csv
+	std::string propagationFilenamePath = "outputs/propagation_";
+
+	// outputs/dag_{CFG}_{RUN_ID}.csv
+	std::string dagFilenamePath = "outputs/dag_";
+
 	progressFilenamePath.append(configFilename).append("_").append(simRunIdString).append(".out");
 	mempoolStatsFilenamePath.append(configFilename).append("_").append(simRunIdString).append(".csv");
 	dataFilenamePath.append(configFilename).append("_").append(simRunIdString).append(".csv");
 	metadataFilenamePath.append(configFilename).append("_").append(simRunIdString).append(".data");
+	propagationFilenamePath.append(configFilename).append("_").append(simRunIdString).append(".csv");
+	dagFilenamePath.append(configFilename).append("_").append(simRunIdString).append(".csv");
 
 	this->progressOutput.open(progressFilenamePath);
 	this->metadataOutput.open(metadataFilenamePath);
-	this->dataOutput.open(dataFilenamePath);
+	if (!this->noData) {
+		this->dataOutput.open(dataFilenamePath);
+	}
+	this->propagationOutput.open(propagationFilenamePath);
 
 	if (this->mpPrintData) {
 		this->mempoolOutput.open(mempoolStatsFilenamePath);
 	}
+
+	if (consensus != CONSENSUS_DEPTH) {
+		this->dagOutput.open(dagFilenamePath);
+	}
 }
 
 void Simulation::printSimulationStart() {
 	// Create full absolute path to config file
-	std::string configFullPath = std::filesystem::canonical(std::filesystem::absolute(this->configPath));
+	std::string configFullPath = "gen:" + topologySpec;
+	if (topologySpec.empty()) {
+		configFullPath = std::filesystem::canonical(std::filesystem::absolute(this->configPath));
+	}
 
 	double honestMinersPower = 0;
 	double maliciousMinersPower = 0;
 
-	int i = 0;
-	for (auto &miner: miners) {
+	for (uint32_t i = 0; i < miners.size(); i++) {
+		Miner &miner = miners[minerIndex(i)];
 		if (miner.getType() == HONEST) {
 			honestMinersCount++;
 			honestMinersPower += miner.getMiningPower();
@@ -224,7 +621,6 @@ void Simulation::printSimulationStart() {
 				firstMaliciousMinerIndex = i;
 			}
 		}
-		i++;
 	}
 
 	// Output progress to file and stdout
@@ -241,22 +637,68 @@ void Simulation::printSimulationStart() {
 	   << "Mempool capacity: " << mpCapacity << std::endl
 	   << "Block size: " << blockSize << std::endl
 	   << "Lambda: " << lambda << std::endl
-	   << "Min. transaction generation time: " << minTxGenTime << " sec" << std::endl
-	   << "Max. transaction generation time: " << maxTxGenTime << " sec" << std::endl
-	   << "Min. transaction generation count: " << minTxGenCount << std::endl
-	   << "Max. transaction generation count: " << maxTxGenCount << std::endl
+	   << "Transaction arrival: " << arrivalProcess->describe() << std::endl
+	   << "Transaction relay: " << (txGossip ? "gossip" : "instant") << std::endl
+	   << "Mempools: " << (lazyMempool ? "lazy" : "eager") << std::endl
+	   << "Block propagation: " << PROPAGATION_MODE_NAMES[propagationMode]
+	   << (compactBlocks ? ", compact blocks" : "");
+	if (propagationMode == PROPAGATION_FLOOD) {
+		ss << ", " << BLOCK_RELAY_NAMES[blockRelay] << " relay";
+	}
+	ss << std::endl
+	   << "Default link bandwidth: " << bandwidth << " Mbit/s" << std::endl
+	   << "Transaction size: " << txVsize << " B" << std::endl
+	   << "Relay network links: " << relayTopology.edgeCount() / 2 << std::endl
+	   << "Miner order: " << REORDER_MODE_NAMES[reorderMode];
+	if (reorderMode != REORDER_NONE) {
+		ss << ", mean neighbor distance " << edgeSpanBefore << " -> " << edgeSpanAfter;
+	}
+	ss << std::endl;
+	if (coarsenThreshold > 0) {
+		ss << "Coarsening: " << originalMinerCount << " -> " << miners.size() << " miners, " << originalLinkCount
+		   << " -> " << topology.edgeCount() / 2 << " links, arrival error max " << std::scientific
+		   << coarseningError.maxError << " s, mean " << coarseningError.meanError << " s" << std::fixed << std::endl;
+	}
+	if (dynamicTopology()) {
+		ss << "Topology events: " << topologyEvents.size() << " declared, churn " << churnRate << "/s (downtime "
+		   << churnDowntime << " s), link failures " << linkFailureRate << "/s (downtime " << linkDowntime << " s)"
+		   << std::endl;
+	}
+	if (validationEnabled()) {
+		ss << "Block validation: " << validationBase << " s + " << validationPerTx << " s per transaction"
+		   << std::endl;
+	}
+	ss << "Consensus: " << CONSENSUS_NAMES[consensus];
+	if (consensus == CONSENSUS_GHOSTDAG) {
+		ss << " (k = " << ghostdagK << ")";
+	}
+	ss << std::endl;
+	if (propagationMode == PROPAGATION_MATRIX) {
+		ss << "Latency matrix: " << (matrixResolution == 0 ? "full precision" : "fixed point") << ", "
+		   << latencyMatrix.memorySize() / (1024 * 1024) << " MiB" << std::endl;
+	}
+	ss
 	   << "========================================================" << std::endl;
 
 	progressOutput << ss.str();
 	std::cout << ss.str();
 
 	// Create headers in output csv files
-	dataOutput << "TransactionID,Fee,BlockID,Depth,MinerID" << std::endl;
+	if (!this->noData) {
+		dataOutput << "TransactionID,Fee,BlockID,Depth,MinerID" << std::endl;
+	}
 
 	if (this->mpPrintData) {
 		mempoolOutput << "MinerID,Progress,MempoolSize" << std::endl;
 	}
 
+	if (consensus == CONSENSUS_GHOSTDAG) {
+		dagOutput << "BlockID,Parents,SelectedParent,BlueScore,Blue,Order" << std::endl;
+	}
+	else if (consensus == CONSENSUS_SPECTRE) {
+		dagOutput << "BlockID,Parents,Order" << std::endl;
+	}
+
 	// Print simulation params info to metadata file
 	metadataOutput << "name=" << configFilename << "_" << simRunIdString << std::endl
 	               << "cfg_path=" << configFullPath << std::endl
@@ -264,6 +706,41 @@ void Simulation::printSimulationStart() {
 	               << "seed=" << seed << std::endl
 	               << "block_size=" << blockSize << std::endl
 	               << "mempool_capacity=" << mpCapacity << std::endl
+	               << "tx_arrival=" << arrivalProcess->describe() << std::endl
+	               << "tx_gossip=" << txGossip << std::endl
+	               << "lazy_mempool=" << lazyMempool << std::endl
+	               << "propagation=" << PROPAGATION_MODE_NAMES[propagationMode] << std::endl
+	               << "matrix_resolution=" << matrixResolution << std::endl
+	               << "bandwidth=" << bandwidth << std::endl
+	               << "tx_vsize=" << txVsize << std::endl
+	               << "compact_blocks=" << compactBlocks << std::endl
+	               << "block_relay=" << BLOCK_RELAY_NAMES[blockRelay] << std::endl
+	               << "relay_links=" << relayTopology.edgeCount() / 2 << std::endl
+	               << "reorder=" << REORDER_MODE_NAMES[reorderMode] << std::endl
+	               << "edge_span_before=" << edgeSpanBefore << std::endl
+	               << "edge_span_after=" << edgeSpanAfter << std::endl
+	               << "coarsen_threshold=" << coarsenThreshold << std::endl
+	               << "coarsen_max_error=" << coarseningError.maxError << std::endl
+	               << "coarsen_mean_error=" << coarseningError.meanError << std::endl;
+	if (coarsenThreshold > 0) {
+		metadataOutput << "coarsen_original_miners=" << originalMinerCount << std::endl
+		               << "coarsen_original_links=" << originalLinkCount << std::endl
+		               << "coarsen_miner_ids=";
+		for (uint32_t i = 0; i < coarsenedMinerIds.size(); i++) {
+			metadataOutput << (i > 0 ? "," : "") << coarsenedMinerIds[i];
+		}
+		metadataOutput << std::endl;
+	}
+	metadataOutput << "declared_topology_events=" << topologyEvents.size() << std::endl
+	               << "churn_rate=" << churnRate << std::endl
+	               << "churn_downtime=" << churnDowntime << std::endl
+	               << "link_failure_rate=" << linkFailureRate << std::endl
+	               << "link_downtime=" << linkDowntime << std::endl
+	               << "block_horizon=" << blockHorizon << std::endl
+	               << "validation_base=" << validationBase << std::endl
+	               << "validation_per_tx=" << validationPerTx << std::endl
+	               << "consensus=" << CONSENSUS_NAMES[consensus] << std::endl
+	               << "ghostdag_k=" << ghostdagK << std::endl
 	               << "malicious_miners=" << maliciousMinersCount << std::endl
 	               << "honest_miners=" << honestMinersCount << std::endl
 	               << "malicious_power=" << std::fixed << std::setprecision(5) << maliciousMinersPower << std::endl
@@ -311,13 +788,13 @@ void Simulation::logProgress(uint32_t blockId) {
 	if (honestMinersCount > 0) {
 		ss << "\t| Honest miner[" << firstHonestMinerIndex << "] - "
 		   << std::fixed << std::setprecision(2)
-		   << double(miners[firstHonestMinerIndex].getMempoolFullness()) / mpCapacity * 100 << "%";
+		   << double(miners[minerIndex(firstHonestMinerIndex)].getMempoolFullness()) / mpCapacity * 100 << "%";
 	}
 
 	if (maliciousMinersCount > 0) {
 		ss << "\t| Malicious miner[" << firstMaliciousMinerIndex << "] - "
 		   << std::fixed << std::setprecision(2)
-		   << double(miners[firstMaliciousMinerIndex].getMempoolFullness()) / mpCapacity * 100 << "%";
+		   << double(miners[minerIndex(firstMaliciousMinerIndex)].getMempoolFullness()) / mpCapacity * 100 << "%";
 	}
 
 	ss << std::endl;
@@ -328,15 +805,33 @@ void Simulation::logProgress(uint32_t blockId) {
 	lastProgressTime = currTime;
 }
 
-void Simulation::logData(uint64_t id, uint32_t fee, uint32_t blockId, uint32_t depth, uint32_t minerId) {
-	dataOutput << id << "," << fee << "," << blockId << "," << depth << "," << minerId << std::endl;
+void Simulation::includeTransaction(TxHandle handle, uint32_t fee, uint32_t blockId, uint32_t depth,
+                                    uint32_t minerId) {
+	inclusions.include(txTable, handle, fee, blockId, minerId);
+	if (!noData) {
+		dataOutput << txTable.txId(handle) << "," << fee << "," << blockId << "," << depth << ","
+		           << configMinerId(minerId) << std::endl;
+	}
+}
+
+bool Simulation::blockPrecedes(uint32_t first, uint32_t second) {
+	switch (consensus) {
+		case CONSENSUS_GHOSTDAG:
+			return ghostdag.precedes(first, second);
+		case CONSENSUS_SPECTRE:
+			return spectre.precedes(first, second);
+		default:
+			return blockStore[first].depth != blockStore[second].depth ? blockStore[first].depth < blockStore[second].depth
+			                                                           : first < second;
+	}
 }
 
 void Simulation::logMempoolDataOfAllMiners() {
 	if (this->mpPrintData) {
-		for (Miner &miner: miners) {
-			mempoolOutput << miner.getMinerId() << "," << progress << "," << miner.getMempoolFullness()
-			              << std::endl;
+		for (uint32_t id = 0; id < miners.size(); id++) {
+			Miner &miner = miners[minerIndex(id)];
+			mempoolOutput << configMinerId(miner.getMinerId()) << "," << progress << ","
+			              << miner.getMempoolFullness() << std::endl;
 		}
 	}
 }
@@ -345,6 +840,86 @@ void Simulation::stopGenerateTransactions() {
 	stopGenerateTransactionsFlag = true;
 }
 
+void Simulation::writeGhostdagOrder() {
+	std::vector<uint32_t> order;
+	std::vector<bool> blue;
+	uint32_t chainLength = ghostdag.computeOrder(order, blue);
+
+	std::vector<uint32_t> positions(order.size(), 0);
+	for (uint32_t i = 0; i < order.size(); i++) {
+		positions[order[i]] = i;
+	}
+
+	uint32_t blueBlocks = 0;
+	for (uint32_t blockId = 0; blockId < dag.blockCount(); blockId++) {
+		const GhostdagBlock &block = ghostdag.block(blockId);
+		blueBlocks += blue[blockId];
+
+		dagOutput << blockId << "," << dag.parentsEnd(blockId) - dag.parentsBegin(blockId) << ",";
+		if (block.selectedParent != GHOSTDAG_NO_BLOCK) {
+			dagOutput << block.selectedParent;
+		}
+		dagOutput << "," << block.blueScore << "," << blue[blockId] << "," << positions[blockId] << std::endl;
+	}
+
+	metadataOutput << "ghostdag_blue_blocks=" << blueBlocks << std::endl
+	               << "ghostdag_red_blocks=" << dag.blockCount() - blueBlocks << std::endl
+	               << "ghostdag_chain_length=" << chainLength << std::endl
+	               << "ghostdag_ancestry_queries=" << ghostdag.ancestryQueryCount() << std::endl
+	               << "reachability_reindexes=" << ghostdag.reachabilityIndex().reindexCount() << std::endl
+	               << "reachability_reindexed_blocks=" << ghostdag.reachabilityIndex().reindexedNodeCount() << std::endl;
+}
+
+void Simulation::writeSpectreOrder() {
+	std::vector<uint32_t> order;
+	spectre.computeOrder(order);
+
+	std::vector<uint32_t> positions(order.size(), 0);
+	for (uint32_t i = 0; i < order.size(); i++) {
+		positions[order[i]] = i;
+	}
+
+	for (uint32_t blockId = 0; blockId < dag.blockCount(); blockId++) {
+		dagOutput << blockId << "," << dag.parentsEnd(blockId) - dag.parentsBegin(blockId) << ","
+		          << positions[blockId] << std::endl;
+	}
+
+	metadataOutput << "spectre_queries=" << spectre.queryCount() << std::endl
+	               << "spectre_votes=" << spectre.voteCount() << std::endl
+	               << "spectre_cached_pairs=" << spectre.cachedPairCount() << std::endl
+	               << "spectre_decided_pairs=" << spectre.decidedPairCount() << std::endl
+	               << "spectre_evicted_pairs=" << spectre.evictedPairCount() << std::endl;
+}
+
+void Simulation::writeInclusionSummary() {
+	inclusions.resolve(UINT32_MAX, [this](uint32_t first, uint32_t second) {
+		return blockPrecedes(first, second);
+	});
+
+	uint64_t txs[2] = {0, 0};
+	uint64_t fees[2] = {0, 0};
+	for (const Miner &miner: miners) {
+		txs[miner.getType()] += inclusions.minerTxCount(miner.getMinerId());
+		fees[miner.getType()] += inclusions.minerFeeSum(miner.getMinerId());
+	}
+
+	double simTime = scheduler.getSimTime();
+	uint64_t includedTxs = inclusions.includedCount();
+	metadataOutput << "included_txs=" << includedTxs << std::endl
+	               << "unique_txs=" << inclusions.uniqueCount() << std::endl
+	               << "duplicate_txs=" << includedTxs - inclusions.uniqueCount() << std::endl
+	               << "unique_ratio="
+	               << (includedTxs > 0 ? double(inclusions.uniqueCount()) / double(includedTxs) : 0) << std::endl
+	               << "unique_fees=" << inclusions.uniqueFeeSum() << std::endl
+	               << "effective_throughput=" << (simTime > 0 ? double(inclusions.uniqueCount()) / simTime : 0)
+	               << std::endl
+	               << "reordered_txs=" << inclusions.reorderedCount() << std::endl
+	               << "honest_effective_txs=" << txs[HONEST] << std::endl
+	               << "honest_effective_fees=" << fees[HONEST] << std::endl
+	               << "malicious_effective_txs=" << txs[MALICIOUS] << std::endl
+	               << "malicious_effective_fees=" << fees[MALICIOUS] << std::endl;
+}
+
 void Simulation::finishSimulation() {
 	time_t currTime = time(nullptr);
 	long timeDiff = long(difftime(currTime, simStartTime));
@@ -355,6 +930,31 @@ void Simulation::finishSimulation() {
 	logTimeInterval(timeDiff, ss);
 	ss << std::endl;
 
+	metadataOutput << "tx_handle_slots=" << txTable.slotCount() << std::endl
+	               << "dropped_txs=" << droppedTxs << std::endl
+	               << "block_transfers=" << blockTransfers << std::endl
+	               << "expired_blocks=" << expiredBlocks << std::endl
+	               << "validated_blocks=" << validatedBlocks << std::endl
+	               << "validation_mean_wait=" << (validatedBlocks > 0 ? validationWaitSum / validatedBlocks : 0)
+	               << std::endl
+	               << "validation_mean_delay=" << (validatedBlocks > 0 ? validationDelaySum / validatedBlocks : 0)
+	               << std::endl
+	               << "validation_max_delay=" << validationDelayMax << std::endl
+	               << "topology_events=" << appliedTopologyEvents << std::endl
+	               << "topology_compactions=" << topologyCompactions << std::endl
+	               << "dag_references=" << dag.referenceCount() << std::endl
+	               << "dag_mean_parents="
+	               << (dag.blockCount() > 0 ? double(dag.referenceCount()) / dag.blockCount() : 0) << std::endl;
+	if (consensus == CONSENSUS_GHOSTDAG) {
+		writeGhostdagOrder();
+	}
+	else if (consensus == CONSENSUS_SPECTRE) {
+		writeSpectreOrder();
+	}
+	writeInclusionSummary();
+	propagationStats.writeSummary(metadataOutput, getStoredBlockCount());
+	propagationStats.writeCsv(propagationOutput, getStoredBlockCount());
+
 	progressOutput << ss.str();
 	std::cout << ss.str();
 }
@@ -398,13 +998,16 @@ void Simulation::errorOutOfTxsExit(Miner &miner) {
 	   << "Simulation error, taking snapshot of miners mempools:" << std::endl
 	   << "=========================== Start of snapshot ===========================" << std::endl
 	   << "MinerID\tMempoolFullness" << std::endl;
-	for (Miner &searched_miner: miners) {
-		ss << searched_miner.getMinerId() << "\t" << searched_miner.getMempoolFullness() << std::endl;
+	for (uint32_t id = 0; id < miners.size(); id++) {
+		Miner &searched_miner = miners[minerIndex(id)];
+		ss << configMinerId(searched_miner.getMinerId()) << "\t" << searched_miner.getMempoolFullness()
+		   << std::endl;
 	}
 	ss << "=========================== Start of snapshot ===========================" << std::endl
-	   << "Miner[" << miner.getMinerId() << "] was chosen to generate block but has run of out of transactions"
-	   << std::endl
-	   << "Miner[" << miner.getMinerId() << "] - " << (miner.getType() == HONEST ? "Honest" : "Malicious") << " with "
+	   << "Miner[" << configMinerId(miner.getMinerId())
+	   << "] was chosen to generate block but has run of out of transactions" << std::endl
+	   << "Miner[" << configMinerId(miner.getMinerId()) << "] - "
+	   << (miner.getType() == HONEST ? "Honest" : "Malicious") << " with "
 	   << miner.getMiningPower() * 100 << "% mining power" << std::endl;
 
 	progressOutput << ss.str();
@@ -465,6 +1068,219 @@ bool Simulation::mpPrintDataEnabled() const {
 	return mpPrintData;
 }
 
+double Simulation::getTrickleInterval() const {
+	return trickleInterval;
+}
+
+uint64_t Simulation::getHorizonTxId() const {
+	return horizonTxId;
+}
+
+bool Simulation::lazyMempoolEnabled() const {
+	return lazyMempool;
+}
+
+bool Simulation::txGossipEnabled() const {
+	return txGossip;
+}
+
+uint64_t Simulation::getArrivalLogEnd() const {
+	return arrivalLogStart + arrivalLog.size();
+}
+
+const Transaction &Simulation::getArrivalLogEntry(uint64_t position) const {
+	return arrivalLog[position - arrivalLogStart];
+}
+
+void Simulation::trimArrivalLog() {
+	uint64_t end = getArrivalLogEnd();
+	for (const Miner &miner: miners) {
+		end = std::min(end, miner.getArrivalLogCursor());
+	}
+
+	for (; arrivalLogStart < end; arrivalLogStart++) {
+		txTable.release(arrivalLog.front().handle);
+		arrivalLog.pop_front();
+	}
+}
+
+void Simulation::consumeBlock(uint32_t blockId) {
+	if (++blockConsumers[blockId] < miners.size()) {
+		return;
+	}
+
+	releaseBlock(blockId);
+}
+
+bool Simulation::txSettled(TxHandle handle) const {
+	// Blocks below the horizon reached all miners or expired, not included transactions have the maximum block id
+	return txTable.inclusionBlock(handle) < horizonBlocks;
+}
+
+void Simulation::releaseBlock(uint32_t blockId) {
+	// Only the header is kept, released handles may be recycled for other transactions
+	Block &block = blockStore[blockId];
+	for (const Transaction &transaction: block.transactions) {
+		txTable.release(transaction.handle);
+	}
+	std::vector<Transaction>().swap(block.transactions);
+}
+
+const Block &Simulation::storeBlock(Block &&block) {
+	double time = scheduler.getSimTime();
+	blockStore.push_back(std::move(block));
+	blockTimes.push_back(time);
+
+	// Blocks that did not reach all miners within the horizon (partitions, departed miners) release their
+	// transactions, so the handles do not leak; their transactions are settled for miners that receive them later
+	while (horizonBlocks < blockStore.size() && blockTimes[horizonBlocks] + blockHorizon <= time) {
+		if (blockArrivals[horizonBlocks] < miners.size()) {
+			releaseBlock(horizonBlocks);
+			expiredBlocks++;
+		}
+		horizonBlocks++;
+	}
+	if (horizonBlocks > resolvedBlocks) {
+		resolveInclusions();
+	}
+
+	return blockStore.back();
+}
+
+const Block &Simulation::getBlock(uint32_t blockId) const {
+	return blockStore[blockId];
+}
+
+void Simulation::blockArrived(const Block &block, const Miner &miner) {
+	uint32_t arrivals = ++blockArrivals[block.id];
+	propagationStats.blockArrived(block.id, configMinerId(miner.getMinerId()), arrivals, miner.getMiningPower(),
+	                              scheduler.getSimTime());
+
+	if (arrivals == miners.size()) {
+		// Lazy mempools may still compare pending blocks with the arrival log, so the block keeps its transactions
+		if (!lazyMempool) {
+			releaseBlock(block.id);
+		}
+
+		while (syncedBlocks < blockStore.size() && blockArrivals[syncedBlocks] == miners.size()) {
+			syncedBlocks++;
+		}
+		resolveInclusions();
+	}
+}
+
+void Simulation::resolveInclusions() {
+	uint32_t watermark = resolvedBlocks;
+	while (watermark < blockStore.size() &&
+	       (watermark < horizonBlocks || blockArrivals[watermark] == miners.size())) {
+		watermark++;
+	}
+	if (watermark == resolvedBlocks) {
+		return;
+	}
+	resolvedBlocks = watermark;
+
+	// Depth order of blocks received by all miners is final, GHOSTDAG and SPECTRE order can still change with
+	// later blocks, so resolving them now approximates the final order by the current one; expired blocks are
+	// resolved by the order at the horizon, before the miners that missed them build on them
+	inclusions.resolve(resolvedBlocks, [this](uint32_t first, uint32_t second) {
+		return blockPrecedes(first, second);
+	});
+	if (consensus == CONSENSUS_SPECTRE) {
+		spectre.evictPairs(resolvedBlocks);
+	}
+}
+
+void Simulation::addDagBlock(uint32_t blockId, const std::vector<uint32_t> &parents) {
+	dag.addBlock(blockId, parents);
+	if (consensus != CONSENSUS_DEPTH) {
+		ghostdag.addBlock(blockId);
+	}
+	if (consensus == CONSENSUS_SPECTRE) {
+		spectre.addBlock(blockId, syncedBlocks);
+	}
+}
+
+const BlockDag &Simulation::getDag() const {
+	return dag;
+}
+
+uint32_t Simulation::getMinerCount() const {
+	return uint32_t(miners.size());
+}
+
+uint32_t Simulation::getStoredBlockCount() const {
+	return uint32_t(blockStore.size());
+}
+
+uint32_t Simulation::getSyncedBlockCount() const {
+	return syncedBlocks;
+}
+
+double Simulation::getBandwidth() const {
+	return bandwidth;
+}
+
+bool Simulation::compactBlocksEnabled() const {
+	return compactBlocks;
+}
+
+BlockRelay Simulation::getBlockRelay() const {
+	return blockRelay;
+}
+
+void Simulation::countBlockTransfer() {
+	blockTransfers++;
+}
+
+bool Simulation::validationEnabled() const {
+	return validationBase > 0 || validationPerTx > 0;
+}
+
+double Simulation::validationTime(const Block &block) const {
+	return validationBase + validationPerTx * double(block.txCount);
+}
+
+void Simulation::countValidation(double wait, double delay) {
+	validatedBlocks++;
+	validationWaitSum += wait;
+	validationDelaySum += delay;
+	validationDelayMax = std::max(validationDelayMax, delay);
+}
+
+PropagationMode Simulation::getPropagationMode() const {
+	return propagationMode;
+}
+
+void Simulation::propagateBlock(uint32_t source, const Block &block) {
+	double time = scheduler.getSimTime();
+
+	const std::vector<double> *arrivals = nullptr;
+	if (propagationMode == PROPAGATION_SHORTEST_PATH) {
+		arrivals = &shortestPathPropagation.computeArrivals(topology, relayTopology, source, block.byteSize(),
+		                                                    randomGen);
+	}
+
+	for (uint32_t i = 0; i < miners.size(); i++) {
+		double arrival = arrivals ? (*arrivals)[i] : latencyMatrix.latency(source, i);
+
+		// Skip the miner itself and unreachable miners
+		if (i == source || arrival == std::numeric_limits<double>::infinity()) {
+			continue;
+		}
+
+		blockTransfers++;
+
+		Miner &miner = miners[i];
+		auto function = [&miner, &block]() { miner.receiveBlock(block); };
+		scheduler.schedule(function, time + arrival);
+	}
+}
+
+TxTable &Simulation::getTxTable() {
+	return txTable;
+}
+
 uint32_t Simulation::getProgress() const {
 	return progress;
 }
@@ -473,6 +1289,18 @@ void Simulation::incrementProgress() {
 	progress++;
 }
 
+const Topology &Simulation::getTopology() const {
+	return topology;
+}
+
+const Topology &Simulation::getRelayTopology() const {
+	return relayTopology;
+}
+
+Miner &Simulation::getMiner(uint32_t index) {
+	return miners[index];
+}
+
 CScheduler &Simulation::getScheduler() {
 	return scheduler;
 }
@@ -20,9 +20,26 @@
 #include <chrono>
 #include <iomanip>
 #include <cstdint>
+#include <memory>
+#include <deque>
 #include "ArgParser.h"
 #include "ConfigParser.h"
 #include "Scheduler.h"
+#include "Block.h"
+#include "BlockDag.h"
+#include "Ghostdag.h"
+#include "Spectre.h"
+#include "Inclusions.h"
+#include "TxTable.h"
+#include "Topology.h"
+#include "TopologyGenerator.h"
+#include "TopologyEvent.h"
+#include "Reordering.h"
+#include "Coarsening.h"
+#include "Propagation.h"
+#include "PropagationStats.h"
+#include "ArrivalProcess.h"
+#include "TraceArrivalProcess.h"
 
 class ArgParser;
 
@@ -36,6 +53,21 @@ class Simulation {
 	const int DATA_OUTPUT_MAX_DIGITS = 4;
 
 	std::string configPath;
+	std::string topologySpec;       // Generated topology specification, empty if topology is read from config
+	std::string topologyName;
+
+	// Miners below the mining power threshold that only relay blocks are collapsed into links
+	double coarsenThreshold = 0.0;  // 0 for no coarsening
+	std::vector<uint32_t> coarsenedMinerIds;    // Configuration id of each miner of coarsened network
+	uint32_t originalMinerCount = 0;
+	size_t originalLinkCount = 0;
+	CoarseningError coarseningError;
+
+	// Miners are stored in reordered layout, outputs keep miner ids from configuration
+	ReorderMode reorderMode = REORDER_NONE;
+	std::vector<uint32_t> minerIndices;     // Index of miner in miners by miner id, empty if not reordered
+	double edgeSpanBefore = 0;
+	double edgeSpanAfter = 0;
 	int32_t seed = 0;
 	uint32_t mpCapacity = 5000;
 	uint32_t maxTxGenCount = 150;
@@ -48,12 +80,86 @@ class Simulation {
 	uint32_t initTxCount = 1000;
 	bool honestRandomRemove = false;
 	bool mpPrintData = false;
+	bool noData = false;    // Included transactions are only counted, data output is not written
+
+	// Transaction arrival process parameters
+	ArrivalProcessType txArrivalType = ARRIVAL_UNIFORM;
+	double txRate = 10.0;               // Transactions per second
+	double txBatchInterval = 10.0;      // Seconds
+	double txBurstFactor = 10.0;
+	double txBurstEnter = 0.05;
+	double txBurstExit = 0.3;
+	double txDiurnalAmplitude = 0.5;
+	double txDiurnalPeriod = 86400.0;   // Seconds
+	std::string txTracePath;
+	double txTraceTimeScale = 1.0;
+	bool txTraceLoop = false;
+
+	// Transaction relay over the topology instead of instant insertion to all mempools
+	bool txGossip = false;
+	double trickleInterval = 5.0;   // Seconds
+	std::deque<std::pair<double, uint64_t>> txBatchStarts;  // Generation time and first id of recent batches
+	uint64_t horizonTxId = 0;       // Transactions with lower id were generated before the block horizon
+
+	// Mempools are reconstructed from the global arrival log only when a miner mines a block
+	bool lazyMempool = false;
+	std::deque<Transaction> arrivalLog;
+	uint64_t arrivalLogStart = 0;           // Position of the first entry, entries read by all miners are trimmed
+	std::vector<uint32_t> blockConsumers;   // Number of mempools that removed transactions of each block
+
+	PropagationMode propagationMode = PROPAGATION_FLOOD;
+	ShortestPathPropagation shortestPathPropagation;
+	LatencyMatrix latencyMatrix;
+	double matrixResolution = 0.0;  // Seconds per fixed point unit of latency matrix, 0 for full precision
+
+	// Block transmission over links with limited bandwidth
+	double bandwidth = 0.0;         // Default link bandwidth in Mbit/s, 0 for unlimited
+	uint32_t txVsize = 250;         // Bytes
+	bool compactBlocks = false;
+
+	// Topology changes during the simulation, declared in the configuration or drawn by stochastic processes
+	std::vector<TopologyEvent> topologyEvents;
+	double churnRate = 0.0;         // Miner departures per second, 0 for no churn
+	double churnDowntime = 600.0;   // Mean time a departed miner stays offline in seconds
+	double linkFailureRate = 0.0;   // Link failures per second, 0 for no failures
+	double linkDowntime = 600.0;    // Mean time a failed link stays down in seconds
+	uint64_t appliedTopologyEvents = 0;
+	uint32_t topologyCompactions = 0;
+
+	BlockRelay blockRelay = BLOCK_RELAY_PUSH;
+	uint64_t blockTransfers = 0;    // Number of block payloads sent between miners
+
+	// Received blocks are validated by a single server queue of each miner before they are stored and relayed
+	double validationBase = 0.0;    // Seconds per block
+	double validationPerTx = 0.0;   // Seconds per transaction of the block
+	uint64_t validatedBlocks = 0;
+	double validationWaitSum = 0.0;     // Time blocks spent waiting for validation of earlier blocks
+	double validationDelaySum = 0.0;    // Time from arrival to the end of validation
+	double validationDelayMax = 0.0;
 
 	uint32_t progress = 0; // %
 
 	CScheduler scheduler;
 	std::mt19937 randomGen;
 	std::vector<Miner> miners;
+	Topology topology;
+	Topology relayTopology;         // Fast relay network overlay (FIBRE-like) declared by relay lines
+	std::deque<Block> blockStore;   // Mined blocks indexed by block id, references stay valid while appending
+	BlockDag dag;
+	ConsensusMode consensus = CONSENSUS_DEPTH;
+	uint32_t ghostdagK = 18;        // Maximum anticone size of blue blocks
+	Ghostdag ghostdag;
+	SpectreOrder spectre;
+	InclusionTracker inclusions;
+	std::vector<uint32_t> blockArrivals;    // Number of miners that have each block
+	std::vector<double> blockTimes;         // Simulation time when each block was mined
+	double blockHorizon = 3600.0;           // Seconds a block holds its transactions if it does not reach all miners
+	uint32_t horizonBlocks = 0;             // Blocks with lower id were checked against the horizon
+	uint32_t expiredBlocks = 0;
+	uint32_t syncedBlocks = 0;              // Blocks with lower id are received by all miners
+	uint32_t resolvedBlocks = 0;            // Blocks with lower id are received by all miners or expired
+	PropagationStats propagationStats;
+	TxTable txTable;
 
 	std::string configFilename;
 	std::string simRunIdString;
@@ -65,6 +171,8 @@ class Simulation {
 	std::ofstream mempoolOutput;
 	std::ofstream dataOutput;
 	std::ofstream metadataOutput;
+	std::ofstream propagationOutput;
+	std::ofstream dagOutput;
 
 	time_t simStartTime;
 	time_t lastProgressTime;
@@ -79,8 +187,8 @@ class Simulation {
 
 	double txGenerationLambda = 150.0;
 
-	std::uniform_int_distribution<> txGenCountDistribution;
-	std::uniform_int_distribution<> txGenTimeDistribution;
+	std::unique_ptr<ArrivalProcess> arrivalProcess;
+	uint64_t droppedTxs = 0;    // Transactions of batches larger than mempool capacity that were not generated
 	std::exponential_distribution<> feeGenDistribution;
 
 	bool stopGenerateTransactionsFlag = false;
@@ -90,6 +198,109 @@ class Simulation {
 	 */
 	void scheduleBlockGenerations();
 
+	/**
+	 * @brief Resolve pending inclusions of blocks that are received by all miners or expired, an expired block may
+	 * never reach some miners and it would hold the resolution of all later blocks
+	 */
+	void resolveInclusions();
+
+	/**
+	 * @brief Relabel miners and rebuild topology so that neighbors are stored close to each other
+	 * @param links bidirectional connections with miner ids
+	 * @param relayLinks connections of the relay network overlay with miner ids
+	 */
+	void reorderMiners(std::vector<Link> &links, std::vector<Link> &relayLinks);
+
+	/**
+	 * @brief Replace miners and topology by coarsened network, eliminated miners give mining power to the closest
+	 * retained miner and retained miners get new ids
+	 * @param links bidirectional connections with miner ids
+	 * @param relayLinks connections of the relay network overlay with miner ids
+	 */
+	void coarsenMiners(std::vector<Link> &links, std::vector<Link> &relayLinks);
+
+	/**
+	 *
+	 * @param id miner id from configuration
+	 * @return Index of the miner in miners
+	 */
+	inline uint32_t minerIndex(uint32_t id) const {
+		return minerIndices.empty() ? id : minerIndices[id];
+	}
+
+	/**
+	 *
+	 * @param id miner id
+	 * @return Configuration id of the miner written to outputs, differs from id in coarsened network
+	 */
+	inline uint32_t configMinerId(uint32_t id) const {
+		return coarsenedMinerIds.empty() ? id : coarsenedMinerIds[id];
+	}
+
+	/**
+	 *
+	 * @return True if the topology changes during the simulation
+	 */
+	inline bool dynamicTopology() const {
+		return !topologyEvents.empty() || churnRate > 0 || linkFailureRate > 0;
+	}
+
+	/**
+	 * @brief Schedule topology events from configuration and first events of stochastic churn and link failures
+	 */
+	void scheduleTopologyEvents();
+
+	/**
+	 *
+	 * @param event topology event with miner ids from configuration
+	 */
+	void applyTopologyEvent(const TopologyEvent &event);
+
+	/**
+	 * @brief Miner leaves or rejoins both networks, rejoining miner synchronizes blocks with its peers
+	 * @param index miner index
+	 * @param online new state of the miner
+	 */
+	void setMinerOnline(uint32_t index, bool online);
+
+	/**
+	 * @brief Remove links of a network that connect the group with the rest of miners
+	 * @param graph peer-to-peer or relay network
+	 * @param groupMiners ids of miners in the group
+	 * @param inGroup bool for each miner index if it is in the group
+	 * @param cutLinks output, removed links with miner indices
+	 */
+	void cutGroupLinks(Topology &graph, const std::vector<uint32_t> &groupMiners, const std::vector<bool> &inGroup,
+	                   std::vector<std::pair<uint32_t, uint32_t>> &cutLinks);
+
+	/**
+	 * @brief Bring back removed links and synchronize blocks over them
+	 * @param links removed peer-to-peer links with miner indices
+	 * @param relayLinks removed relay network links with miner indices
+	 */
+	void restoreLinks(const std::vector<std::pair<uint32_t, uint32_t>> &links,
+	                  const std::vector<std::pair<uint32_t, uint32_t>> &relayLinks);
+
+	/**
+	 * @brief Merge topology updates into compressed arrays when there are enough of them
+	 */
+	void compactTopology();
+
+	/**
+	 * @brief Stochastic churn event, random online miner leaves the network for exponentially distributed time
+	 */
+	void churnMiner();
+
+	/**
+	 * @brief Stochastic link failure event, random link goes down for exponentially distributed time
+	 */
+	void failLink();
+
+	/**
+	 * @brief Create transaction arrival process selected by program arguments
+	 */
+	void createArrivalProcess();
+
 	/**
 	 * @brief Event to generate initial transactions to all miners
 	 */
@@ -137,14 +348,22 @@ public:
 	void logProgress(uint32_t blockId);
 
 	/**
-	 *
-	 * @param id transaction id
+	 * @brief Count a transaction included in a mined block and log it to the data output
+	 * @param handle transaction handle
 	 * @param fee transaction fee
 	 * @param blockId id of a block
 	 * @param depth blockchain depth (height)
 	 * @param minerId id of a miner
 	 */
-	void logData(uint64_t id, uint32_t fee, uint32_t blockId, uint32_t depth, uint32_t minerId);
+	void includeTransaction(TxHandle handle, uint32_t fee, uint32_t blockId, uint32_t depth, uint32_t minerId);
+
+	/**
+	 *
+	 * @param first block
+	 * @param second another block
+	 * @return True if the first block precedes the second one in the order of the selected consensus
+	 */
+	bool blockPrecedes(uint32_t first, uint32_t second);
 
 	/**
 	 * @brief Store mempool data of all miners
@@ -156,6 +375,21 @@ public:
 	 */
 	void stopGenerateTransactions();
 
+	/**
+	 * @brief Order all mined blocks by GHOSTDAG, write them to the dag output and their summary to metadata
+	 */
+	void writeGhostdagOrder();
+
+	/**
+	 * @brief Order all mined blocks by SPECTRE votes, write them to the dag output and vote statistics to metadata
+	 */
+	void writeSpectreOrder();
+
+	/**
+	 * @brief Resolve remaining conflicting inclusions and write effective throughput and fees to metadata
+	 */
+	void writeInclusionSummary();
+
 	/**
 	 * @brief Output a simulation duration
 	 */
@@ -245,6 +479,183 @@ public:
 	 */
 	bool mpPrintDataEnabled() const;
 
+	/**
+	 *
+	 * @return Mean interval between inventory trickles of a miner in seconds
+	 */
+	double getTrickleInterval() const;
+
+	/**
+	 *
+	 * @return Transactions with lower id were generated more than block horizon ago, gossip treats them as seen
+	 */
+	uint64_t getHorizonTxId() const;
+
+	/**
+	 *
+	 * @return Bool if miners materialize their mempools only when they mine
+	 */
+	bool lazyMempoolEnabled() const;
+
+	/**
+	 *
+	 * @return Bool if transactions are relayed over the topology
+	 */
+	bool txGossipEnabled() const;
+
+	/**
+	 *
+	 * @return Position after the last generated transaction in the arrival log (lazy mempool mode)
+	 */
+	uint64_t getArrivalLogEnd() const;
+
+	/**
+	 *
+	 * @param position position in the arrival log that was not read by all miners yet
+	 * @return Generated transaction
+	 */
+	const Transaction &getArrivalLogEntry(uint64_t position) const;
+
+	/**
+	 * @brief Drop entries of the arrival log that were read by all miners and release their transactions
+	 */
+	void trimArrivalLog();
+
+	/**
+	 * @brief Release transaction references of a stored block and drop its transactions, it is safe to call it again
+	 * @param blockId id of the block
+	 */
+	void releaseBlock(uint32_t blockId);
+
+	/**
+	 * @brief Transaction included in a block older than the horizon is confirmed for all miners, even for those
+	 * that did not receive the block before it expired
+	 * @param handle transaction handle
+	 * @return True if the transaction must not be included again
+	 */
+	bool txSettled(TxHandle handle) const;
+
+	/**
+	 * @brief Transactions of the block were removed from a lazy mempool, the block releases its transactions when
+	 * all mempools removed them
+	 * @param blockId id of the block
+	 */
+	void consumeBlock(uint32_t blockId);
+
+	/**
+	 * @brief Take ownership of mined block
+	 * @param block mined block
+	 * @return Reference to the stored block that is valid until the end of the simulation
+	 */
+	const Block &storeBlock(Block &&block);
+
+	/**
+	 *
+	 * @param blockId id of a mined block
+	 * @return Stored block
+	 */
+	const Block &getBlock(uint32_t blockId) const;
+
+	/**
+	 * @brief Add a mined block to the DAG and order it by the selected consensus
+	 * @param blockId id of the block
+	 * @param parents ids of parent blocks
+	 */
+	void addDagBlock(uint32_t blockId, const std::vector<uint32_t> &parents);
+
+	/**
+	 *
+	 * @return Parent references of mined blocks
+	 */
+	const BlockDag &getDag() const;
+
+	/**
+	 * @brief Count a miner that has received (or mined) the block, block releases its transactions when all have it
+	 * @param block received block
+	 * @param miner miner that received the block
+	 */
+	void blockArrived(const Block &block, const Miner &miner);
+
+	/**
+	 *
+	 * @return Number of miners
+	 */
+	uint32_t getMinerCount() const;
+
+	/**
+	 *
+	 * @return Number of mined blocks
+	 */
+	uint32_t getStoredBlockCount() const;
+
+	/**
+	 *
+	 * @return Number of blocks (from id 0) that are received by all miners
+	 */
+	uint32_t getSyncedBlockCount() const;
+
+	/**
+	 *
+	 * @return Block propagation model
+	 */
+	PropagationMode getPropagationMode() const;
+
+	/**
+	 * @brief Schedule arrivals of a mined block to all other miners (non-flood propagation modes)
+	 * @param source index of the miner that mined the block
+	 * @param block mined block
+	 */
+	void propagateBlock(uint32_t source, const Block &block);
+
+	/**
+	 *
+	 * @return Default link bandwidth in Mbit/s, 0 for unlimited
+	 */
+	double getBandwidth() const;
+
+	/**
+	 *
+	 * @return Bool if blocks are relayed as compact blocks
+	 */
+	bool compactBlocksEnabled() const;
+
+	/**
+	 *
+	 * @return Block relay protocol of flood propagation
+	 */
+	BlockRelay getBlockRelay() const;
+
+	/**
+	 * @brief Count a block payload sent between miners
+	 */
+	void countBlockTransfer();
+
+	/**
+	 *
+	 * @return Bool if received blocks are delayed by validation
+	 */
+	bool validationEnabled() const;
+
+	/**
+	 *
+	 * @param block received block
+	 * @return Seconds of CPU time needed to validate the block
+	 */
+	double validationTime(const Block &block) const;
+
+	/**
+	 * @brief Count a block queued for validation
+	 * @param wait seconds the block waits for validation of earlier blocks
+	 * @param delay seconds from arrival to the end of validation
+	 */
+	void countValidation(double wait, double delay);
+
+	/**
+	 *
+	 * @return Table of live transactions
+	 */
+	TxTable &getTxTable();
+
 	/**
 	 *
 	 * @return Current simulation percentage progress
@@ -256,6 +667,25 @@ public:
 	 */
 	void incrementProgress();
 
+	/**
+	 *
+	 * @return Peer-to-peer network of miners
+	 */
+	const Topology &getTopology() const;
+
+	/**
+	 *
+	 * @return Relay network overlay, it has no edges if the configuration does not declare any
+	 */
+	const Topology &getRelayTopology() const;
+
+	/**
+	 *
+	 * @param index miner index in the topology
+	 * @return Miner reference
+	 */
+	Miner &getMiner(uint32_t index);
+
 	/**
 	 *
 	 * @return Scheduler reference
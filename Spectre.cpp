@@ -0,0 +1,164 @@
+/**
+ * @file Spectre.cpp
+ * @brief SPECTRE pairwise ordering of blocks, votes of each queried pair are cached and extended by new blocks
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include "Spectre.h"
+
+void SpectreOrder::init(const BlockDag *_dag, const ReachabilityIndex *_reachability) {
+	dag = _dag;
+	reachability = _reachability;
+	watermarks.clear();
+	pairs.clear();
+	queries = 0;
+	votes = 0;
+	decidedPairs = 0;
+	evictedPairs = 0;
+	evictionThreshold = SPECTRE_EVICTION_MIN_PAIRS;
+}
+
+void SpectreOrder::addBlock(uint32_t blockId, uint32_t watermark) {
+	if (blockId != watermarks.size()) {
+		throw std::logic_error("Blocks have to be added to SPECTRE in the order of their ids");
+	}
+	if (!watermarks.empty() && watermark < watermarks.back()) {
+		throw std::logic_error("Watermark of SPECTRE voters cannot decrease");
+	}
+
+	watermarks.push_back(std::min(blockId, watermark));
+}
+
+bool SpectreOrder::precedes(uint32_t first, uint32_t second) {
+	queries++;
+	if (first == second) {
+		return false;
+	}
+	if (reachability->isAncestor(first, second)) {
+		return true;
+	}
+	if (reachability->isAncestor(second, first)) {
+		return false;
+	}
+
+	uint32_t lower = std::min(first, second);
+	uint32_t higher = std::max(first, second);
+	PairVotes &pair = pairs[uint64_t(lower) << 32 | higher];
+	if (!pair.decided) {
+		updateVotes(lower, higher, pair);
+	}
+
+	// Tie goes to the block with lower id
+	return (pair.margin >= 0) == (first == lower);
+}
+
+void SpectreOrder::evictPairs(uint32_t watermark) {
+	if (pairs.size() < evictionThreshold) {
+		return;
+	}
+
+	for (auto it = pairs.begin(); it != pairs.end();) {
+		// Key holds the block with higher id in the lower half
+		if (uint32_t(it->first) < watermark) {
+			decidedPairs -= it->second.decided ? 1 : 0;
+			evictedPairs++;
+			it = pairs.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+	evictionThreshold = std::max(SPECTRE_EVICTION_MIN_PAIRS, 2 * pairs.size());
+}
+
+void SpectreOrder::updateVotes(uint32_t first, uint32_t second, PairVotes &pair) {
+	auto blockCount = uint32_t(watermarks.size());
+
+	// Blocks mined before the first block cannot have any of them in the past
+	pair.nextVoter = std::max(pair.nextVoter, first);
+	for (; pair.nextVoter < blockCount && !pair.decided; pair.nextVoter++) {
+		uint32_t voter = pair.nextVoter;
+		uint32_t watermark = watermarks[voter];
+		while (!pair.recentVotes.empty() && pair.recentVotes.front().first < watermark) {
+			pair.recentVotes.pop_front();
+		}
+
+		bool afterFirst = watermark > first || inPast(first, voter);
+		bool afterSecond = watermark > second || inPast(second, voter);
+		if (!afterFirst && !afterSecond) {
+			continue;
+		}
+
+		int8_t vote = afterFirst ? 1 : -1;
+		if (afterFirst && afterSecond) {
+			// Voters older than the watermark are in the past, only recent ones are checked
+			int64_t pastMargin = pair.margin;
+			for (auto &[recentVoter, recentVote]: pair.recentVotes) {
+				if (!reachability->isAncestor(recentVoter, voter)) {
+					pastMargin -= recentVote;
+				}
+			}
+			vote = pastMargin >= 0 ? 1 : -1;
+		}
+
+		pair.margin += vote;
+		pair.recentVotes.emplace_back(voter, vote);
+		votes++;
+
+		if (watermark > second && uint64_t(std::abs(pair.margin)) > pair.recentVotes.size()) {
+			pair.decided = true;
+			pair.recentVotes = std::deque<std::pair<uint32_t, int8_t>>();
+			decidedPairs++;
+		}
+	}
+}
+
+void SpectreOrder::computeOrder(std::vector<uint32_t> &order) {
+	auto blockCount = uint32_t(watermarks.size());
+	order.clear();
+	order.reserve(blockCount);
+
+	std::vector<uint32_t> missingParents(blockCount, 0);
+	std::vector<uint32_t> ready;
+	for (uint32_t blockId = 0; blockId < blockCount; blockId++) {
+		missingParents[blockId] = uint32_t(dag->parentsEnd(blockId) - dag->parentsBegin(blockId));
+		if (missingParents[blockId] == 0) {
+			ready.push_back(blockId);
+		}
+	}
+
+	std::vector<uint32_t> wins;
+	while (!ready.empty()) {
+		// Ready blocks are in anticone of each other, the block with most pairwise wins goes first
+		wins.assign(ready.size(), 0);
+		for (size_t i = 0; i < ready.size(); i++) {
+			for (size_t j = i + 1; j < ready.size(); j++) {
+				wins[precedes(ready[i], ready[j]) ? i : j]++;
+			}
+		}
+
+		size_t best = 0;
+		for (size_t i = 1; i < ready.size(); i++) {
+			if (wins[i] > wins[best] || (wins[i] == wins[best] && ready[i] < ready[best])) {
+				best = i;
+			}
+		}
+
+		uint32_t blockId = ready[best];
+		ready.erase(ready.begin() + long(best));
+		order.push_back(blockId);
+
+		for (uint32_t reference = dag->firstChildReference(blockId); reference != DAG_NO_REFERENCE;
+		     reference = dag->nextChildReference(reference)) {
+			uint32_t child = dag->referenceBlock(reference);
+			if (--missingParents[child] == 0) {
+				ready.push_back(child);
+			}
+		}
+	}
+}
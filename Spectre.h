@@ -0,0 +1,153 @@
+/**
+ * @file Spectre.h
+ * @brief SPECTRE pairwise ordering of blocks, votes of each queried pair are cached and extended by new blocks
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef SPECTRE_H
+#define SPECTRE_H
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <cstdint>
+#include "BlockDag.h"
+#include "Reachability.h"
+
+// Pairs below the watermark are evicted once the cache doubles since the last eviction, at least minimum count
+const size_t SPECTRE_EVICTION_MIN_PAIRS = 4096;
+
+/**
+ * @brief Votes of voters processed so far for a pair of blocks, positive margin means the block with lower id precedes
+ */
+class PairVotes {
+public:
+	uint32_t nextVoter = 0;
+	int64_t margin = 0;
+	bool decided = false;
+	std::deque<std::pair<uint32_t, int8_t>> recentVotes;    // Voters that may be outside the past of later blocks
+};
+
+/**
+ * @brief Block z votes on pair (x, y) of blocks in anticone of each other. If only x is in the past of z or z is x, z
+ * votes x before y. If both are in its past, z votes as the majority of voters in its past, ties go to the block with
+ * lower id. Blocks in the past of neither should vote with the majority of their future, leaving them out is
+ * a deliberate simplification that can change the result of close votes, not an equivalent of the protocol. Votes
+ * depend only on the past of the voter, so they are processed once in the order of block ids and cached per pair.
+ * Pairs whose blocks are both below the watermark of resolved inclusions are not queried again until the final
+ * order, so they are evicted and recomputed from scratch if needed. Blocks below the synchronization watermark of a voter are in its past, so only recent
+ * votes need ancestry checks. Once both blocks are below the watermark and the margin exceeds the number of recent
+ * votes, every later voter follows the majority and the pair is decided.
+ */
+class SpectreOrder {
+	const BlockDag *dag = nullptr;
+	const ReachabilityIndex *reachability = nullptr;
+
+	std::vector<uint32_t> watermarks;   // Blocks with lower id are in the past of each block
+	std::unordered_map<uint64_t, PairVotes> pairs;
+
+	uint64_t queries = 0;
+	uint64_t votes = 0;
+	uint64_t decidedPairs = 0;
+	uint64_t evictedPairs = 0;
+	size_t evictionThreshold = SPECTRE_EVICTION_MIN_PAIRS;
+
+	/**
+	 * @brief Process votes of blocks that were added since the last query of the pair
+	 * @param first block with lower id
+	 * @param second block with higher id
+	 * @param pair cached votes
+	 */
+	void updateVotes(uint32_t first, uint32_t second, PairVotes &pair);
+
+	/**
+	 *
+	 * @param ancestor block
+	 * @param block block
+	 * @return True if ancestor is the block or it is in its past
+	 */
+	inline bool inPast(uint32_t ancestor, uint32_t block) const {
+		return ancestor == block || reachability->isAncestor(ancestor, block);
+	}
+
+public:
+	/**
+	 *
+	 * @param _dag block DAG
+	 * @param _reachability reachability index that contains all added blocks
+	 */
+	void init(const BlockDag *_dag, const ReachabilityIndex *_reachability);
+
+	/**
+	 * @brief Record a block that was just added to the DAG and to the reachability index
+	 * @param blockId id of the block
+	 * @param watermark blocks with lower id are received by the miner of the block, it does not decrease
+	 */
+	void addBlock(uint32_t blockId, uint32_t watermark);
+
+	/**
+	 *
+	 * @param first block
+	 * @param second another block
+	 * @return True if the first block precedes the second one
+	 */
+	bool precedes(uint32_t first, uint32_t second);
+
+	/**
+	 * @brief Drop cached pairs of blocks below the watermark, votes of a dropped pair are processed again on the next
+	 * query with the same result
+	 * @param watermark blocks with lower id are not queried anymore until the final order
+	 */
+	void evictPairs(uint32_t watermark);
+
+	/**
+	 * @brief Topological order of all blocks, among blocks whose parents are ordered the one that precedes most of
+	 * the others goes first
+	 * @param order output, block ids in SPECTRE order
+	 */
+	void computeOrder(std::vector<uint32_t> &order);
+
+	/**
+	 *
+	 * @return Number of pairwise queries
+	 */
+	inline uint64_t queryCount() const {
+		return queries;
+	}
+
+	/**
+	 *
+	 * @return Number of processed votes of all pairs
+	 */
+	inline uint64_t voteCount() const {
+		return votes;
+	}
+
+	/**
+	 *
+	 * @return Number of cached pairs
+	 */
+	inline size_t cachedPairCount() const {
+		return pairs.size();
+	}
+
+	/**
+	 *
+	 * @return Number of cached pairs whose order cannot change
+	 */
+	inline uint64_t decidedPairCount() const {
+		return decidedPairs;
+	}
+
+	/**
+	 *
+	 * @return Number of pairs dropped from the cache
+	 */
+	inline uint64_t evictedPairCount() const {
+		return evictedPairs;
+	}
+};
+
+#endif //SPECTRE_H
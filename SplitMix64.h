@@ -0,0 +1,58 @@
+/**
+ * @file SplitMix64.h
+ * @brief Small and fast random generator for per-miner random streams
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef SPLITMIX64_H
+#define SPLITMIX64_H
+
+#include <cstdint>
+
+/**
+ * @brief Splitmix64 generator, state of a single 64-bit word makes it cheap to keep one stream per miner, unlike
+ * std::mt19937 with 5 kB state. Satisfies UniformRandomBitGenerator, so it works with standard distributions.
+ */
+class SplitMix64 {
+	uint64_t state;
+
+public:
+	typedef uint64_t result_type;
+
+	/**
+	 *
+	 * @param seed initial state
+	 */
+	explicit SplitMix64(uint64_t seed = 0) : state(seed) {}
+
+	static constexpr result_type min() {
+		return 0;
+	}
+
+	static constexpr result_type max() {
+		return UINT64_MAX;
+	}
+
+	/**
+	 *
+	 * @return Next random value
+	 */
+	inline result_type operator()() {
+		uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		return z ^ (z >> 31);
+	}
+
+	/**
+	 *
+	 * @return Random value in <0, 1) with 53-bit resolution
+	 */
+	inline double nextUnit() {
+		return double((*this)() >> 11) * (1.0 / 9007199254740992.0);
+	}
+};
+
+#endif //SPLITMIX64_H
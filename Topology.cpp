@@ -0,0 +1,199 @@
+/**
+ * @file Topology.cpp
+ * @brief Peer-to-peer network topology stored in compressed sparse row format
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#include "Topology.h"
+
+Topology::Topology(uint32_t nodeCount, const std::vector<Link> &links) : offsets(nodeCount + 1, 0),
+                                                                          neighbors(links.size() * 2),
+                                                                          latencies(links.size() * 2),
+                                                                          bandwidths(links.size() * 2),
+                                                                          jitterLows(links.size() * 2),
+                                                                          jitterSpans(links.size() * 2),
+                                                                          removed(links.size() * 2, 0),
+                                                                          offline(nodeCount, 0) {
+	// Count degrees and turn them into offsets
+	for (const Link &link: links) {
+		offsets[link.miner1 + 1]++;
+		offsets[link.miner2 + 1]++;
+	}
+	for (uint32_t i = 0; i < nodeCount; i++) {
+		offsets[i + 1] += offsets[i];
+	}
+
+	// Fill edges in the order of links
+	std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+	for (const Link &link: links) {
+		uint32_t edge = next[link.miner1]++;
+		neighbors[edge] = link.miner2;
+		latencies[edge] = link.latency;
+		bandwidths[edge] = link.bandwidth;
+
+		edge = next[link.miner2]++;
+		neighbors[edge] = link.miner1;
+		latencies[edge] = link.latency;
+		bandwidths[edge] = link.bandwidth;
+	}
+
+	for (size_t edge = 0; edge < latencies.size(); edge++) {
+		jitterLows[edge] = latencies[edge] / BLOCK_PROPAGAITON_JITTER_DIFF_MIN;
+		jitterSpans[edge] = latencies[edge] / BLOCK_PROPAGAITON_JITTER_DIFF_MAX - jitterLows[edge];
+	}
+}
+
+void Topology::sampleJitters(uint32_t node, SplitMix64 &randomGen, std::vector<double> &jitters) const {
+	uint32_t first = offsets[node];
+	uint32_t count = offsets[node + 1] - first;
+	uint32_t slots = slotCount(node);
+	jitters.resize(slots);
+
+	for (uint32_t i = 0; i < count; i++) {
+		jitters[i] = randomGen.nextUnit();
+	}
+
+	const double *lows = jitterLows.data() + first;
+	const double *spans = jitterSpans.data() + first;
+	double *out = jitters.data();
+	for (uint32_t i = 0; i < count; i++) {
+		out[i] = lows[i] + spans[i] * out[i];
+	}
+
+	// Added edges are scattered behind the compressed arrays
+	for (uint32_t slot = count; slot < slots; slot++) {
+		jitters[slot] = jitter(slotEdge(node, slot), randomGen.nextUnit());
+	}
+}
+
+uint32_t Topology::findEdge(uint32_t node, uint32_t peer, bool removedEdge) const {
+	for (uint32_t slot = 0; slot < slotCount(node); slot++) {
+		uint32_t edge = slotEdge(node, slot);
+		if (neighbors[edge] == peer && bool(removed[edge]) == removedEdge) {
+			return edge;
+		}
+	}
+	return uint32_t(edgeCount());
+}
+
+void Topology::appendEdge(uint32_t node, const Link &link) {
+	if (addedEdges.empty()) {
+		addedEdges.resize(nodeCount());
+	}
+	addedEdges[node].push_back(uint32_t(neighbors.size()));
+
+	neighbors.push_back(node == link.miner1 ? link.miner2 : link.miner1);
+	latencies.push_back(link.latency);
+	bandwidths.push_back(link.bandwidth);
+	jitterLows.push_back(link.latency / BLOCK_PROPAGAITON_JITTER_DIFF_MIN);
+	jitterSpans.push_back(link.latency / BLOCK_PROPAGAITON_JITTER_DIFF_MAX - jitterLows.back());
+	removed.push_back(0);
+}
+
+void Topology::assignEdge(uint32_t edge, const Link &link) {
+	latencies[edge] = link.latency;
+	bandwidths[edge] = link.bandwidth;
+	jitterLows[edge] = link.latency / BLOCK_PROPAGAITON_JITTER_DIFF_MIN;
+	jitterSpans[edge] = link.latency / BLOCK_PROPAGAITON_JITTER_DIFF_MAX - jitterLows[edge];
+}
+
+void Topology::setNodeOnline(uint32_t node, bool online) {
+	offline[node] = !online;
+}
+
+bool Topology::removeLink(uint32_t node1, uint32_t node2) {
+	uint32_t edge1 = findEdge(node1, node2, false);
+	uint32_t edge2 = findEdge(node2, node1, false);
+	if (edge1 == edgeCount() || edge2 == edgeCount()) {
+		return false;
+	}
+
+	removed[edge1] = 1;
+	removed[edge2] = 1;
+	removedLinks[std::minmax(node1, node2)] = {node1, node2, latencies[edge1], bandwidths[edge1]};
+	updates++;
+	return true;
+}
+
+bool Topology::restoreLink(uint32_t node1, uint32_t node2) {
+	auto it = removedLinks.find(std::minmax(node1, node2));
+	if (it == removedLinks.end()) {
+		return false;
+	}
+	Link link = it->second;
+	removedLinks.erase(it);
+
+	// Masked edges are reused, edges dropped by compaction are added again
+	uint32_t edge1 = findEdge(node1, node2, true);
+	uint32_t edge2 = findEdge(node2, node1, true);
+	if (edge1 != edgeCount() && edge2 != edgeCount()) {
+		removed[edge1] = 0;
+		removed[edge2] = 0;
+		updates--;
+		return true;
+	}
+	return addLink(link);
+}
+
+bool Topology::addLink(const Link &link) {
+	if (findEdge(link.miner1, link.miner2, false) != edgeCount()) {
+		return false;
+	}
+
+	// Parameters of a removed link are outdated, a later restore must not bring them back
+	removedLinks.erase(std::minmax(link.miner1, link.miner2));
+
+	// Masked edges are reused, so the nodes never have parallel edges
+	uint32_t edge1 = findEdge(link.miner1, link.miner2, true);
+	uint32_t edge2 = findEdge(link.miner2, link.miner1, true);
+	if (edge1 != edgeCount() && edge2 != edgeCount()) {
+		assignEdge(edge1, link);
+		assignEdge(edge2, link);
+		removed[edge1] = 0;
+		removed[edge2] = 0;
+		updates--;
+		return true;
+	}
+
+	appendEdge(link.miner1, link);
+	appendEdge(link.miner2, link);
+	updates++;
+	return true;
+}
+
+void Topology::compact() {
+	std::vector<uint32_t> newOffsets(offsets.size(), 0);
+	std::vector<uint32_t> newNeighbors;
+	std::vector<double> newLatencies;
+	std::vector<double> newBandwidths;
+	std::vector<double> newJitterLows;
+	std::vector<double> newJitterSpans;
+
+	// Edges keep their slot order, removed edges are dropped
+	for (uint32_t node = 0; node < nodeCount(); node++) {
+		for (uint32_t slot = 0; slot < slotCount(node); slot++) {
+			uint32_t edge = slotEdge(node, slot);
+			if (removed[edge]) {
+				continue;
+			}
+			newNeighbors.push_back(neighbors[edge]);
+			newLatencies.push_back(latencies[edge]);
+			newBandwidths.push_back(bandwidths[edge]);
+			newJitterLows.push_back(jitterLows[edge]);
+			newJitterSpans.push_back(jitterSpans[edge]);
+		}
+		newOffsets[node + 1] = uint32_t(newNeighbors.size());
+	}
+
+	offsets.swap(newOffsets);
+	neighbors.swap(newNeighbors);
+	latencies.swap(newLatencies);
+	bandwidths.swap(newBandwidths);
+	jitterLows.swap(newJitterLows);
+	jitterSpans.swap(newJitterSpans);
+	removed.assign(neighbors.size(), 0);
+	addedEdges.clear();
+	updates = 0;
+}
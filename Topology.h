@@ -0,0 +1,289 @@
+/**
+ * @file Topology.h
+ * @brief Peer-to-peer network topology stored in compressed sparse row format
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <algorithm>
+#include <utility>
+#include "SplitMix64.h"
+
+// Jitter of block propagation delay is uniformly distributed in <latency / MIN, latency / MAX>
+const double BLOCK_PROPAGAITON_JITTER_DIFF_MIN = -1000.0;
+const double BLOCK_PROPAGAITON_JITTER_DIFF_MAX = 1000.0;
+
+// Edge updates are merged into the compressed arrays when they exceed a fraction of edges, at least minimum count
+const size_t TOPOLOGY_COMPACTION_MIN_UPDATES = 1024;
+const size_t TOPOLOGY_COMPACTION_EDGE_DIVISOR = 8;
+
+/**
+ * @brief Bidirectional connection between two miners as defined in the configuration
+ */
+class Link {
+public:
+	uint32_t miner1;
+	uint32_t miner2;
+	double latency;     // Seconds
+	double bandwidth;   // Bytes per second, 0 for unlimited
+};
+
+/**
+ * @brief Directed edges of node u are stored in interval <offsets[u], offsets[u + 1]) of contiguous neighbor and
+ * latency arrays. Edges of a node keep the order in which links were defined.
+ *
+ * Topology can change during the simulation without rebuilding. Removed edges are only masked and edges of added
+ * links are appended behind the compressed arrays and listed per node (delta overlay). Edge slot is a position of
+ * edge among all edges of a node, compressed edges first and added edges after them. Slots stay stable until
+ * updates are compacted into new compressed arrays.
+ */
+class Topology {
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> neighbors;
+	std::vector<double> latencies;
+	std::vector<double> bandwidths;
+
+	// Jitter of edge is jitterLows[edge] + jitterSpans[edge] * <0, 1)
+	std::vector<double> jitterLows;
+	std::vector<double> jitterSpans;
+
+	// Dynamic updates since the last compaction
+	std::vector<uint8_t> removed;                   // Masked edges
+	std::vector<uint8_t> offline;                   // Nodes that left the network, their edges are kept
+	std::vector<std::vector<uint32_t>> addedEdges;  // Edges of added links by node, empty until first addition
+	std::map<std::pair<uint32_t, uint32_t>, Link> removedLinks;    // Parameters of removed links to restore them
+	size_t updates = 0;
+
+	/**
+	 *
+	 * @param node node index
+	 * @param peer neighbor node index
+	 * @param removedEdge state of the searched edge
+	 * @return Edge from node to peer in given state, edgeCount() if there is none
+	 */
+	uint32_t findEdge(uint32_t node, uint32_t peer, bool removedEdge) const;
+
+	/**
+	 * @brief Append an edge behind the compressed arrays
+	 * @param node source node index
+	 * @param link link that produces the edge
+	 */
+	void appendEdge(uint32_t node, const Link &link);
+
+	/**
+	 * @brief Overwrite latency, bandwidth and jitter bounds of an existing edge
+	 * @param edge edge index
+	 * @param link link that produces the edge
+	 */
+	void assignEdge(uint32_t edge, const Link &link);
+
+public:
+	Topology() = default;
+
+	/**
+	 *
+	 * @param nodeCount number of miners
+	 * @param links bidirectional links, each link produces one edge in both directions
+	 */
+	Topology(uint32_t nodeCount, const std::vector<Link> &links);
+
+	/**
+	 *
+	 * @return Number of nodes
+	 */
+	inline uint32_t nodeCount() const {
+		return offsets.empty() ? 0 : uint32_t(offsets.size() - 1);
+	}
+
+	/**
+	 *
+	 * @return Number of directed edges
+	 */
+	inline size_t edgeCount() const {
+		return neighbors.size();
+	}
+
+	/**
+	 *
+	 * @param node node index
+	 * @return Index of the first edge of the node
+	 */
+	inline uint32_t edgesBegin(uint32_t node) const {
+		return offsets[node];
+	}
+
+	/**
+	 *
+	 * @param node node index
+	 * @return Index after the last edge of the node
+	 */
+	inline uint32_t edgesEnd(uint32_t node) const {
+		return offsets[node + 1];
+	}
+
+	/**
+	 *
+	 * @param node node index
+	 * @return Number of neighbors of the node
+	 */
+	inline uint32_t degree(uint32_t node) const {
+		return offsets[node + 1] - offsets[node];
+	}
+
+	/**
+	 *
+	 * @param node node index
+	 * @return Number of edge slots of the node, including removed and added edges
+	 */
+	inline uint32_t slotCount(uint32_t node) const {
+		return degree(node) + (addedEdges.empty() ? 0 : uint32_t(addedEdges[node].size()));
+	}
+
+	/**
+	 *
+	 * @param node node index
+	 * @param slot edge slot of the node
+	 * @return Edge index
+	 */
+	inline uint32_t slotEdge(uint32_t node, uint32_t slot) const {
+		uint32_t nodeDegree = degree(node);
+		return slot < nodeDegree ? offsets[node] + slot : addedEdges[node][slot - nodeDegree];
+	}
+
+	/**
+	 *
+	 * @param edge edge index
+	 * @return True if the link of the edge was removed
+	 */
+	inline bool edgeRemoved(uint32_t edge) const {
+		return removed[edge];
+	}
+
+	/**
+	 *
+	 * @param node source node of the edge
+	 * @param edge edge index
+	 * @return True if the edge is not removed and both of its nodes are online
+	 */
+	inline bool edgeActive(uint32_t node, uint32_t edge) const {
+		return !removed[edge] && !offline[node] && !offline[neighbors[edge]];
+	}
+
+	/**
+	 *
+	 * @param node node index
+	 * @return True if the node is part of the network
+	 */
+	inline bool nodeOnline(uint32_t node) const {
+		return !offline[node];
+	}
+
+	/**
+	 * @brief Node leaves or rejoins the network, its edges are kept for the time it comes back
+	 * @param node node index
+	 * @param online new state of the node
+	 */
+	void setNodeOnline(uint32_t node, bool online);
+
+	/**
+	 * @brief Mask both edges of a link
+	 * @param node1 first node index
+	 * @param node2 second node index
+	 * @return False if there is no such link
+	 */
+	bool removeLink(uint32_t node1, uint32_t node2);
+
+	/**
+	 * @brief Bring back a removed link with its original parameters
+	 * @param node1 first node index
+	 * @param node2 second node index
+	 * @return False if the link was not removed before
+	 */
+	bool restoreLink(uint32_t node1, uint32_t node2);
+
+	/**
+	 * @brief Add a new link to the delta overlay, removed link between the nodes gets the new parameters instead
+	 * @param link link between two nodes
+	 * @return False if the nodes are already connected
+	 */
+	bool addLink(const Link &link);
+
+	/**
+	 *
+	 * @return True if there are enough updates to merge them into compressed arrays
+	 */
+	inline bool needsCompaction() const {
+		return updates >= std::max(TOPOLOGY_COMPACTION_MIN_UPDATES, edgeCount() / TOPOLOGY_COMPACTION_EDGE_DIVISOR);
+	}
+
+	/**
+	 * @brief Rebuild compressed arrays without removed edges and with added edges, edge slots are renumbered
+	 */
+	void compact();
+
+	/**
+	 *
+	 * @param edge edge index
+	 * @return Target node of the edge
+	 */
+	inline uint32_t neighbor(uint32_t edge) const {
+		return neighbors[edge];
+	}
+
+	/**
+	 *
+	 * @param edge edge index
+	 * @return Block propagation delay of the edge in seconds
+	 */
+	inline double latency(uint32_t edge) const {
+		return latencies[edge];
+	}
+
+	/**
+	 *
+	 * @param edge edge index
+	 * @return Bandwidth of the edge in bytes per second, 0 for unlimited
+	 */
+	inline double bandwidth(uint32_t edge) const {
+		return bandwidths[edge];
+	}
+
+	/**
+	 *
+	 * @param edge edge index
+	 * @param unit random value in <0, 1)
+	 * @return Jitter of block propagation delay of the edge in seconds
+	 */
+	inline double jitter(uint32_t edge, double unit) const {
+		return jitterLows[edge] + jitterSpans[edge] * unit;
+	}
+
+	/**
+	 * @brief Draw jitter of all edges of a node at once, random values are drawn first and then scaled in a single
+	 * loop over contiguous arrays that the compiler vectorizes
+	 * @param node node index
+	 * @param randomGen Random generator of the node
+	 * @param jitters output, jitter of the edge in i-th slot of the node in seconds
+	 */
+	void sampleJitters(uint32_t node, SplitMix64 &randomGen, std::vector<double> &jitters) const;
+
+	/**
+	 *
+	 * @param edge edge index
+	 * @param bytes size of transferred message
+	 * @return Time to transmit the message over the edge in seconds, without latency
+	 */
+	inline double transmissionDelay(uint32_t edge, double bytes) const {
+		return bandwidths[edge] > 0 ? bytes / bandwidths[edge] : 0;
+	}
+};
+
+#endif //TOPOLOGY_H
@@ -0,0 +1,42 @@
+/**
+ * @file TopologyEvent.h
+ * @brief Scheduled change of the peer-to-peer network (link failure, node churn, network partition)
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef TOPOLOGYEVENT_H
+#define TOPOLOGYEVENT_H
+
+#include <vector>
+#include <cstdint>
+#include "Topology.h"
+
+enum TopologyEventType {
+	EVENT_LINK_DOWN,
+	EVENT_LINK_UP,
+	EVENT_NODE_DOWN,
+	EVENT_NODE_UP,
+	EVENT_PARTITION
+};
+
+const char *const TOPOLOGY_EVENT_NAMES[] = {"link_down", "link_up", "node_down", "node_up", "partition"};
+
+/**
+ * @brief Topology event as declared in the configuration, miners are referenced by their ids
+ */
+class TopologyEvent {
+public:
+	double time;                    // Seconds
+	TopologyEventType type;
+
+	// Link of link events, link up without latency restores previously removed link
+	Link link;
+	bool hasLatency = false;
+
+	std::vector<uint32_t> miners;   // Node events use the first miner, partition separates all listed miners
+	double duration = 0;            // Seconds until partition heals
+};
+
+#endif //TOPOLOGYEVENT_H
@@ -0,0 +1,377 @@
+/**
+ * @file TopologyGenerator.cpp
+ * @brief Generate miners and their connections in memory instead of parsing a configuration file
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#include <cmath>
+#include <numeric>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include "TopologyGenerator.h"
+#include "Simulation.h"
+#include "Miner.h"
+#include "distributionData/BlockPropagationDelay.h"
+
+TopologyGenerator::TopologyGenerator(const std::string &spec) {
+	std::istringstream specStream(spec);
+	std::string token;
+
+	std::getline(specStream, token, ',');
+	if (token == "regular") {
+		model = TOPOLOGY_REGULAR;
+	}
+	else if (token == "ba") {
+		model = TOPOLOGY_BA;
+	}
+	else if (token == "geo") {
+		model = TOPOLOGY_GEO;
+	}
+	else {
+		throw std::runtime_error("Invalid topology specification - unknown model " + token);
+	}
+
+	while (std::getline(specStream, token, ',')) {
+		size_t sepPos = token.find('=');
+		if (sepPos == std::string::npos) {
+			throw std::runtime_error("Invalid topology specification - expected key=value, got " + token);
+		}
+
+		std::string key = token.substr(0, sepPos);
+		std::string value = token.substr(sepPos + 1);
+
+		try {
+			if (key == "nodes") {
+				nodes = std::stoul(value);
+			}
+			else if (key == "degree") {
+				degree = std::stoul(value);
+			}
+			else if (key == "power") {
+				if (value == "uniform") {
+					power = POWER_UNIFORM;
+				}
+				else if (value == "zipf") {
+					power = POWER_ZIPF;
+				}
+				else if (value == "exp") {
+					power = POWER_EXP;
+				}
+				else {
+					throw std::invalid_argument(value);
+				}
+			}
+			else if (key == "zipf_exponent") {
+				zipfExponent = std::stod(value);
+			}
+			else if (key == "malicious") {
+				malicious = std::stod(value);
+			}
+			else if (key == "placement") {
+				if (value == "random") {
+					placement = PLACEMENT_RANDOM;
+				}
+				else if (value == "largest") {
+					placement = PLACEMENT_LARGEST;
+				}
+				else if (value == "hubs") {
+					placement = PLACEMENT_HUBS;
+				}
+				else {
+					throw std::invalid_argument(value);
+				}
+			}
+			else if (key == "delay") {
+				delay = std::stod(value);
+			}
+			else if (key == "clusters") {
+				clusters = std::stoul(value);
+			}
+			else if (key == "local") {
+				local = std::stod(value);
+			}
+			else if (key == "local_delay") {
+				localDelay = std::stod(value);
+			}
+			else if (key == "remote_delay") {
+				remoteDelay = std::stod(value);
+			}
+			else {
+				throw std::runtime_error("Invalid topology specification - unknown key " + key);
+			}
+		} catch (std::logic_error &e) {
+			throw std::runtime_error("Invalid topology specification - invalid value of " + key);
+		}
+	}
+
+	if (nodes < 2) {
+		throw std::runtime_error("Invalid topology specification - at least 2 nodes are required");
+	}
+	if (degree < 1 || degree >= nodes) {
+		throw std::runtime_error("Invalid topology specification - degree must be in range <1, nodes)");
+	}
+	if (malicious < 0 || malicious > 1) {
+		throw std::runtime_error("Invalid topology specification - malicious power must be in range <0, 1>");
+	}
+	if (clusters < 1 || local < 0 || local > 1 || localDelay < 0 || remoteDelay < 0) {
+		throw std::runtime_error("Invalid topology specification - invalid geographic cluster parameters");
+	}
+}
+
+std::vector<Miner> TopologyGenerator::generate(Simulation &simulation, std::vector<Link> &links) const {
+	std::mt19937 &randomGen = simulation.getRandomGen();
+
+	std::vector<std::pair<uint32_t, uint32_t>> edges;
+	std::vector<uint32_t> cluster;
+	if (model == TOPOLOGY_REGULAR) {
+		generateRegular(randomGen, edges);
+	}
+	else if (model == TOPOLOGY_BA) {
+		generateBa(randomGen, edges);
+	}
+	else {
+		generateGeo(randomGen, edges, cluster);
+	}
+
+	// Remove self loops and duplicate links in one pass over sorted edges
+	for (auto &edge: edges) {
+		if (edge.first > edge.second) {
+			std::swap(edge.first, edge.second);
+		}
+	}
+	std::sort(edges.begin(), edges.end());
+	edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+	edges.erase(std::remove_if(edges.begin(), edges.end(), [](const std::pair<uint32_t, uint32_t> &edge) {
+		return edge.first == edge.second;
+	}), edges.end());
+	connectComponents(edges);
+
+	// Links get the same delay and bandwidth units as links from configuration file
+	double bandwidth = simulation.getBandwidth() * 1000000.0 / 8;
+	std::vector<uint32_t> degrees(nodes, 0);
+	links.clear();
+	links.reserve(edges.size());
+	for (const auto &edge: edges) {
+		double connectionDelay;
+		if (model == TOPOLOGY_GEO) {
+			connectionDelay = cluster[edge.first] == cluster[edge.second] ? localDelay : remoteDelay;
+		}
+		else if (delay >= 0) {
+			connectionDelay = delay;
+		}
+		else {
+			connectionDelay = double(blockPropDelayTable(randomGen));
+		}
+
+		links.push_back({edge.first, edge.second, connectionDelay / 1000, bandwidth});
+		degrees[edge.first]++;
+		degrees[edge.second]++;
+	}
+
+	std::vector<double> miningPower = generatePower(randomGen);
+	std::vector<bool> maliciousMiners = placeMalicious(randomGen, miningPower, degrees);
+
+	std::vector<Miner> miners;
+	miners.reserve(nodes);
+	for (uint32_t i = 0; i < nodes; i++) {
+		miners.emplace_back(miningPower[i], maliciousMiners[i] ? MALICIOUS : HONEST, simulation);
+	}
+
+	return miners;
+}
+
+void TopologyGenerator::generateRegular(std::mt19937 &randomGen,
+                                        std::vector<std::pair<uint32_t, uint32_t>> &edges) const {
+	std::vector<uint32_t> stubs;
+	stubs.reserve(size_t(nodes) * degree);
+	for (uint32_t node = 0; node < nodes; node++) {
+		stubs.insert(stubs.end(), degree, node);
+	}
+
+	// Rare self loops and duplicates are removed afterwards, so the graph is only approximately regular
+	std::shuffle(stubs.begin(), stubs.end(), randomGen);
+	edges.reserve(stubs.size() / 2);
+	for (size_t i = 0; i + 1 < stubs.size(); i += 2) {
+		edges.emplace_back(stubs[i], stubs[i + 1]);
+	}
+}
+
+void TopologyGenerator::generateBa(std::mt19937 &randomGen, std::vector<std::pair<uint32_t, uint32_t>> &edges) const {
+	uint32_t attach = std::max(1u, degree / 2);
+
+	// Every edge adds both endpoints, uniform choice from endpoints is proportional to degree
+	std::vector<uint32_t> endpoints;
+	endpoints.reserve(size_t(nodes) * attach * 2);
+	edges.reserve(size_t(nodes) * attach);
+
+	// Initial clique of attach + 1 nodes
+	for (uint32_t i = 0; i <= attach; i++) {
+		for (uint32_t j = i + 1; j <= attach; j++) {
+			edges.emplace_back(i, j);
+			endpoints.push_back(i);
+			endpoints.push_back(j);
+		}
+	}
+
+	std::vector<uint32_t> targets;
+	for (uint32_t node = attach + 1; node < nodes; node++) {
+		targets.clear();
+		while (targets.size() < attach) {
+			std::uniform_int_distribution<size_t> endpointIndex(0, endpoints.size() - 1);
+			uint32_t target = endpoints[endpointIndex(randomGen)];
+			if (std::find(targets.begin(), targets.end(), target) == targets.end()) {
+				targets.push_back(target);
+			}
+		}
+
+		for (uint32_t target: targets) {
+			edges.emplace_back(node, target);
+			endpoints.push_back(node);
+			endpoints.push_back(target);
+		}
+	}
+}
+
+void TopologyGenerator::generateGeo(std::mt19937 &randomGen, std::vector<std::pair<uint32_t, uint32_t>> &edges,
+                                    std::vector<uint32_t> &cluster) const {
+	std::uniform_int_distribution<uint32_t> clusterIndex(0, clusters - 1);
+	std::uniform_int_distribution<uint32_t> nodeIndex(0, nodes - 1);
+	std::bernoulli_distribution localLink(local);
+
+	cluster.resize(nodes);
+	std::vector<std::vector<uint32_t>> members(clusters);
+	for (uint32_t node = 0; node < nodes; node++) {
+		cluster[node] = clusterIndex(randomGen);
+		members[cluster[node]].push_back(node);
+	}
+
+	// Each link is created by one of its endpoints, so mean degree is degree
+	uint32_t outgoing = std::max(1u, degree / 2);
+	edges.reserve(size_t(nodes) * outgoing);
+	for (uint32_t node = 0; node < nodes; node++) {
+		const std::vector<uint32_t> &neighbors = members[cluster[node]];
+
+		for (uint32_t i = 0; i < outgoing; i++) {
+			uint32_t peer;
+			if (neighbors.size() > 1 && localLink(randomGen)) {
+				std::uniform_int_distribution<size_t> memberIndex(0, neighbors.size() - 1);
+				peer = neighbors[memberIndex(randomGen)];
+			}
+			else {
+				peer = nodeIndex(randomGen);
+			}
+			edges.emplace_back(node, peer);
+		}
+	}
+}
+
+void TopologyGenerator::connectComponents(std::vector<std::pair<uint32_t, uint32_t>> &edges) const {
+	// Union-find with path halving, each component is represented by its root
+	std::vector<uint32_t> parents(nodes);
+	std::iota(parents.begin(), parents.end(), 0);
+	auto find = [&parents](uint32_t node) {
+		while (parents[node] != node) {
+			parents[node] = parents[parents[node]];
+			node = parents[node];
+		}
+		return node;
+	};
+
+	for (const auto &edge: edges) {
+		parents[find(edge.first)] = find(edge.second);
+	}
+
+	// Nodes are visited in order, so the first node of a new component is linked to the first node of the previous one
+	std::vector<bool> seen(nodes, false);
+	uint32_t previous = nodes;
+	size_t componentEdges = edges.size();
+	for (uint32_t node = 0; node < nodes; node++) {
+		uint32_t root = find(node);
+		if (seen[root]) {
+			continue;
+		}
+		seen[root] = true;
+
+		if (previous != nodes) {
+			edges.emplace_back(previous, node);
+		}
+		previous = node;
+	}
+
+	// Added links join different components, so they are neither self loops nor duplicates
+	if (edges.size() != componentEdges) {
+		std::sort(edges.begin(), edges.end());
+	}
+}
+
+std::vector<double> TopologyGenerator::generatePower(std::mt19937 &randomGen) const {
+	std::vector<double> miningPower(nodes, 1.0);
+
+	if (power == POWER_ZIPF) {
+		// Ranks are assigned in random order, so mining power does not follow node index or degree
+		std::vector<uint32_t> ranks(nodes);
+		std::iota(ranks.begin(), ranks.end(), 1);
+		std::shuffle(ranks.begin(), ranks.end(), randomGen);
+		for (uint32_t i = 0; i < nodes; i++) {
+			miningPower[i] = std::pow(double(ranks[i]), -zipfExponent);
+		}
+	}
+	else if (power == POWER_EXP) {
+		std::exponential_distribution<> weight(1.0);
+		for (double &minerPower: miningPower) {
+			minerPower = weight(randomGen);
+		}
+	}
+
+	double totalPower = std::accumulate(miningPower.begin(), miningPower.end(), 0.0);
+	for (double &minerPower: miningPower) {
+		minerPower /= totalPower;
+	}
+
+	return miningPower;
+}
+
+std::vector<bool> TopologyGenerator::placeMalicious(std::mt19937 &randomGen, const std::vector<double> &miningPower,
+                                                    const std::vector<uint32_t> &degrees) const {
+	std::vector<bool> maliciousMiners(nodes, false);
+	if (malicious == 0) {
+		return maliciousMiners;
+	}
+
+	std::vector<uint32_t> order(nodes);
+	std::iota(order.begin(), order.end(), 0);
+
+	if (placement == PLACEMENT_RANDOM) {
+		std::shuffle(order.begin(), order.end(), randomGen);
+	}
+	else if (placement == PLACEMENT_LARGEST) {
+		std::stable_sort(order.begin(), order.end(), [&miningPower](uint32_t a, uint32_t b) {
+			return miningPower[a] > miningPower[b];
+		});
+	}
+	else {
+		std::stable_sort(order.begin(), order.end(), [&degrees](uint32_t a, uint32_t b) {
+			return degrees[a] > degrees[b];
+		});
+	}
+
+	// Miners are taken in placement order until their power reaches the requested fraction
+	double maliciousPower = 0;
+	for (uint32_t node: order) {
+		if (maliciousPower >= malicious - TOPOLOGY_POWER_EPS) {
+			break;
+		}
+		maliciousMiners[node] = true;
+		maliciousPower += miningPower[node];
+	}
+
+	return maliciousMiners;
+}
+
+std::string TopologyGenerator::name() const {
+	const char *modelNames[] = {"regular", "ba", "geo"};
+	return std::string("gen-") + modelNames[model] + "-" + std::to_string(nodes);
+}
@@ -0,0 +1,124 @@
+/**
+ * @file TopologyGenerator.h
+ * @brief Generate miners and their connections in memory instead of parsing a configuration file
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef TOPOLOGYGENERATOR_H
+#define TOPOLOGYGENERATOR_H
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include "Topology.h"
+
+class Miner;
+
+class Simulation;
+
+// Malicious miners are placed until their power is within this distance from the requested fraction
+const double TOPOLOGY_POWER_EPS = 0.000001;
+
+enum TopologyModel {
+	TOPOLOGY_REGULAR,   // Random regular graph
+	TOPOLOGY_BA,        // Barabasi-Albert preferential attachment
+	TOPOLOGY_GEO        // Geographic clusters with cheap local and expensive remote links
+};
+
+enum PowerDistribution {
+	POWER_UNIFORM,
+	POWER_ZIPF,
+	POWER_EXP
+};
+
+enum MaliciousPlacement {
+	PLACEMENT_RANDOM,   // Random miners
+	PLACEMENT_LARGEST,  // Miners with the highest mining power
+	PLACEMENT_HUBS      // Miners with the highest degree
+};
+
+/**
+ * @brief Topology is given by specification "model,key=value,..." (e.g. "ba,nodes=100000,degree=8,power=zipf").
+ * Graph is built from an edge list that is sorted once to remove self loops and duplicate links, so generation
+ * takes O(E log E) and million-node topologies are ready in seconds.
+ */
+class TopologyGenerator {
+	TopologyModel model = TOPOLOGY_REGULAR;
+	uint32_t nodes = 1000;
+	uint32_t degree = 8;
+	PowerDistribution power = POWER_UNIFORM;
+	double zipfExponent = 1.0;
+	double malicious = 0.0;             // Fraction of mining power
+	MaliciousPlacement placement = PLACEMENT_RANDOM;
+	double delay = -1;                  // Milliseconds, negative draws delays from Bitcoin network data
+	uint32_t clusters = 8;
+	double local = 0.8;                 // Probability that a link stays in the cluster
+	double localDelay = 50;             // Milliseconds
+	double remoteDelay = 150;           // Milliseconds
+
+	/**
+	 * @brief Pair randomly shuffled stubs, each node has degree stubs
+	 */
+	void generateRegular(std::mt19937 &randomGen, std::vector<std::pair<uint32_t, uint32_t>> &edges) const;
+
+	/**
+	 * @brief Each new node connects to degree / 2 distinct nodes chosen proportionally to their degree
+	 */
+	void generateBa(std::mt19937 &randomGen, std::vector<std::pair<uint32_t, uint32_t>> &edges) const;
+
+	/**
+	 * @brief Each node connects to degree / 2 nodes, to a node in its own cluster with probability local
+	 * @param cluster output, cluster of each node
+	 */
+	void generateGeo(std::mt19937 &randomGen, std::vector<std::pair<uint32_t, uint32_t>> &edges,
+	                 std::vector<uint32_t> &cluster) const;
+
+	/**
+	 * @brief Low degree or local links may leave the graph split into components, blocks would never reach all
+	 * miners. The first node of each component is linked to the first node of the previous component.
+	 * @param edges links without duplicates, output with the added links
+	 */
+	void connectComponents(std::vector<std::pair<uint32_t, uint32_t>> &edges) const;
+
+	/**
+	 *
+	 * @return Relative mining power of each node, sums to 1
+	 */
+	std::vector<double> generatePower(std::mt19937 &randomGen) const;
+
+	/**
+	 *
+	 * @param miningPower mining power of each node
+	 * @param degrees degree of each node
+	 * @return Bool for each node if it is malicious
+	 */
+	std::vector<bool> placeMalicious(std::mt19937 &randomGen, const std::vector<double> &miningPower,
+	                                 const std::vector<uint32_t> &degrees) const;
+
+public:
+	/**
+	 *
+	 * @param spec topology specification without "gen:" prefix
+	 * @throw std::runtime_error if specification is invalid
+	 */
+	explicit TopologyGenerator(const std::string &spec);
+
+	/**
+	 *
+	 * @param simulation Simulator instance
+	 * @param links output of generated bidirectional connections
+	 * @return Generated miners
+	 */
+	std::vector<Miner> generate(Simulation &simulation, std::vector<Link> &links) const;
+
+	/**
+	 *
+	 * @return Name of the generated topology used in output filenames
+	 */
+	std::string name() const;
+};
+
+#endif //TOPOLOGYGENERATOR_H
@@ -0,0 +1,99 @@
+/**
+ * @file TraceArrivalProcess.cpp
+ * @brief Trace-driven transaction arrivals streamed from a memory-mapped binary trace file
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "TraceArrivalProcess.h"
+
+TraceArrivalProcess::TraceArrivalProcess(const std::string &_path, double _interval, double _timeScale, bool _loop)
+		: path(_path), interval(_interval), timeScale(_timeScale), loop(_loop) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1) {
+		throw std::runtime_error("Cannot open transaction trace file");
+	}
+
+	struct stat fileStat{};
+	if (fstat(fd, &fileStat) == -1 || size_t(fileStat.st_size) < sizeof(TraceHeader)) {
+		close(fd);
+		throw std::runtime_error("Invalid transaction trace file - missing header");
+	}
+
+	mappingSize = size_t(fileStat.st_size);
+	mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (mapping == MAP_FAILED) {
+		mapping = nullptr;
+		throw std::runtime_error("Cannot map transaction trace file");
+	}
+
+	// Trace is read once from start to end
+	madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+
+	auto header = static_cast<const TraceHeader *>(mapping);
+	if (std::memcmp(header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 || header->version != TRACE_VERSION) {
+		munmap(mapping, mappingSize);
+		throw std::runtime_error("Invalid transaction trace file - unknown format or version");
+	}
+
+	recordCount = header->recordCount;
+	if (recordCount == 0 || recordCount > (mappingSize - sizeof(TraceHeader)) / sizeof(TraceRecord)) {
+		munmap(mapping, mappingSize);
+		throw std::runtime_error("Invalid transaction trace file - invalid record count");
+	}
+
+	records = reinterpret_cast<const TraceRecord *>(static_cast<const char *>(mapping) + sizeof(TraceHeader));
+	traceStart = records[0].timestamp;
+
+	// Next loop starts one mean gap after the last record, so the last and the first record do not coincide
+	double span = records[recordCount - 1].timestamp - traceStart;
+	double gap = recordCount > 1 ? span / double(recordCount - 1) : 0;
+	traceDuration = span + (gap > 0 ? gap : interval / timeScale);
+}
+
+TraceArrivalProcess::~TraceArrivalProcess() {
+	if (mapping != nullptr) {
+		munmap(mapping, mappingSize);
+	}
+}
+
+ArrivalBatch TraceArrivalProcess::nextBatch(double simTime, std::mt19937 &) {
+	if (cursor == recordCount) {
+		if (!loop) {
+			return {0, interval};
+		}
+
+		cursor = 0;
+		loopCount++;
+	}
+
+	// Batch contains all records that arrive before the next batch, it never crosses the end of the trace
+	// so it is always a contiguous view into the mapping
+	double batchEnd = simTime + interval;
+	uint64_t first = cursor;
+	while (cursor < recordCount && recordTime(cursor) < batchEnd) {
+		cursor++;
+	}
+
+	ArrivalBatch batch{uint32_t(cursor - first), interval};
+	batch.records = records + first;
+
+	return batch;
+}
+
+std::string TraceArrivalProcess::describe() const {
+	std::stringstream ss;
+	ss << "trace (" << path << ", " << recordCount << " records, scale " << timeScale << ", batch " << interval
+	   << " sec" << (loop ? ", loop" : "") << ")";
+	return ss.str();
+}
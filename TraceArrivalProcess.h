@@ -0,0 +1,90 @@
+/**
+ * @file TraceArrivalProcess.h
+ * @brief Trace-driven transaction arrivals streamed from a memory-mapped binary trace file
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef TRACEARRIVALPROCESS_H
+#define TRACEARRIVALPROCESS_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "ArrivalProcess.h"
+
+// Binary trace starts with this magic followed by TraceHeader fields and packed TraceRecord entries
+const char TRACE_MAGIC[8] = {'D', 'A', 'G', 'T', 'R', 'A', 'C', 'E'};
+const uint32_t TRACE_VERSION = 1;
+
+class TraceHeader {
+public:
+	char magic[8];
+	uint32_t version;
+	uint32_t reserved;
+	uint64_t recordCount;
+};
+
+class TraceRecord {
+public:
+	double timestamp;   // Seconds, records are sorted in ascending order
+	uint32_t fee;
+	uint32_t vsize;     // Bytes, 0 for transactions of size --tx_vsize
+};
+
+static_assert(sizeof(TraceHeader) == 24, "Unexpected trace header layout");
+static_assert(sizeof(TraceRecord) == 16, "Unexpected trace record layout");
+
+/**
+ * @brief Batches are views into the mapped file, transactions are never parsed or copied
+ */
+class TraceArrivalProcess : public ArrivalProcess {
+	std::string path;
+	double interval;
+	double timeScale;
+	bool loop;
+
+	void *mapping = nullptr;
+	size_t mappingSize = 0;
+	const TraceRecord *records = nullptr;
+	uint64_t recordCount = 0;
+
+	// Trace time of the first record and period of the trace used for looping
+	double traceStart = 0;
+	double traceDuration = 0;
+
+	uint64_t cursor = 0;
+	uint64_t loopCount = 0;
+
+	/**
+	 *
+	 * @param index record index
+	 * @return Simulation time of the record in the current loop
+	 */
+	inline double recordTime(uint64_t index) const {
+		return (records[index].timestamp - traceStart + double(loopCount) * traceDuration) * timeScale;
+	}
+
+public:
+	/**
+	 *
+	 * @param _path path to the binary trace file
+	 * @param _interval batch interval in seconds
+	 * @param _timeScale multiplier applied to trace time (0.5 replays the trace twice as fast)
+	 * @param _loop replay the trace from the beginning when it is exhausted
+	 */
+	TraceArrivalProcess(const std::string &_path, double _interval, double _timeScale, bool _loop);
+
+	~TraceArrivalProcess() override;
+
+	TraceArrivalProcess(const TraceArrivalProcess &) = delete;
+
+	TraceArrivalProcess &operator=(const TraceArrivalProcess &) = delete;
+
+	ArrivalBatch nextBatch(double simTime, std::mt19937 &randomGen) override;
+
+	std::string describe() const override;
+};
+
+#endif //TRACEARRIVALPROCESS_H
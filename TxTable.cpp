@@ -0,0 +1,44 @@
+/**
+ * @file TxTable.cpp
+ * @brief Table of live transactions addressed by compact 32-bit handles with recycled slots
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#include <stdexcept>
+#include "TxTable.h"
+
+TxHandle TxTable::acquire(uint64_t txId, uint32_t vsize) {
+	TxHandle handle;
+
+	if (!freeSlots.empty()) {
+		handle = freeSlots.back();
+		freeSlots.pop_back();
+		txIds[handle] = txId;
+		vsizes[handle] = vsize;
+		inclusionBlocks[handle] = TX_NOT_INCLUDED;
+	}
+	else {
+		if (txIds.size() > UINT32_MAX) {
+			throw std::runtime_error("Number of live transactions exceeds transaction handle range");
+		}
+
+		handle = TxHandle(txIds.size());
+		txIds.push_back(txId);
+		vsizes.push_back(vsize);
+		refCounts.push_back(0);
+		inclusionBlocks.push_back(TX_NOT_INCLUDED);
+	}
+
+	refCounts[handle] = 1;
+	return handle;
+}
+
+size_t TxTable::liveCount() const {
+	return txIds.size() - freeSlots.size();
+}
+
+size_t TxTable::slotCount() const {
+	return txIds.size();
+}
@@ -0,0 +1,109 @@
+/**
+ * @file TxTable.h
+ * @brief Table of live transactions addressed by compact 32-bit handles with recycled slots
+ * @author Tomas Hladky <xhladk15@stud.fit.vutbr.cz>
+ * @author Martin Peresini <iperesini@fit.vut.cz>
+ * @date 2021 - 2022
+ */
+
+#ifndef TXTABLE_H
+#define TXTABLE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+typedef uint32_t TxHandle;
+
+const uint32_t TX_NOT_INCLUDED = UINT32_MAX;
+
+/**
+ * @brief Each slot keeps the original 64-bit transaction id and size once, mempools, blocks and relay queues store only
+ * the handle. A slot is returned to the free list when the last reference (mempool entry, block record, queued
+ * announcement or arrival log entry) is released. Slot also keeps the block that first included the
+ * transaction, a transaction cannot be included again once its slot is recycled.
+ */
+class TxTable {
+	std::vector<uint64_t> txIds;
+	std::vector<uint32_t> vsizes;
+	std::vector<uint32_t> refCounts;
+	std::vector<uint32_t> inclusionBlocks;
+	std::vector<TxHandle> freeSlots;
+
+public:
+	/**
+	 * @brief Allocate handle for a new transaction, returned handle holds one reference owned by the caller
+	 * @param txId original transaction id
+	 * @param vsize size of the transaction in bytes
+	 * @return Handle of the transaction
+	 */
+	TxHandle acquire(uint64_t txId, uint32_t vsize);
+
+	/**
+	 *
+	 * @param handle transaction handle
+	 */
+	inline void retain(TxHandle handle) {
+		refCounts[handle]++;
+	}
+
+	/**
+	 * @brief Drop one reference, slot is recycled when there is no reference left
+	 * @param handle transaction handle
+	 */
+	inline void release(TxHandle handle) {
+		if (--refCounts[handle] == 0) {
+			freeSlots.push_back(handle);
+		}
+	}
+
+	/**
+	 *
+	 * @param handle transaction handle
+	 * @return Original 64-bit transaction id
+	 */
+	inline uint64_t txId(TxHandle handle) const {
+		return txIds[handle];
+	}
+
+	/**
+	 *
+	 * @param handle transaction handle
+	 * @return Size of the transaction in bytes
+	 */
+	inline uint32_t vsize(TxHandle handle) const {
+		return vsizes[handle];
+	}
+
+	/**
+	 *
+	 * @param handle transaction handle
+	 * @return Block that first included the transaction, TX_NOT_INCLUDED if there is none
+	 */
+	inline uint32_t inclusionBlock(TxHandle handle) const {
+		return inclusionBlocks[handle];
+	}
+
+	/**
+	 *
+	 * @param handle transaction handle
+	 * @param blockId block that first included the transaction
+	 */
+	inline void setInclusionBlock(TxHandle handle, uint32_t blockId) {
+		inclusionBlocks[handle] = blockId;
+	}
+
+	/**
+	 *
+	 * @return Number of transactions that are currently referenced
+	 */
+	size_t liveCount() const;
+
+	/**
+	 *
+	 * @return Number of allocated slots (peak of live transactions)
+	 */
+	size_t slotCount() const;
+};
+
+#endif //TXTABLE_H
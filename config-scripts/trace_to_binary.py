@@ -0,0 +1,56 @@
+import sys
+import struct
+import argparse
+
+TRACE_MAGIC = b'DAGTRACE'
+TRACE_VERSION = 1
+RECORD_FORMAT = '<dII'
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--csv', type=str, required=True,
+                        help='Input trace in csv format (timestamp,fee[,vsize]), header row is optional, '
+                             'rows without vsize use --tx_vsize of the simulator')
+    parser.add_argument('--output', type=str, required=True,
+                        help='Output binary trace for simulator')
+    args = parser.parse_args()
+
+    count = 0
+    last_timestamp = None
+
+    with open(args.csv, 'r') as csv_file, open(args.output, 'wb') as output_file:
+        # Record count is written at the end
+        output_file.write(struct.pack('<8sIIQ', TRACE_MAGIC, TRACE_VERSION, 0, 0))
+
+        for row in csv_file:
+            values = row.rstrip('\n').split(',')
+            if len(values) not in (2, 3):
+                print(f'Invalid trace row: {row}', file=sys.stderr)
+                exit(1)
+
+            try:
+                timestamp = float(values[0])
+                fee = int(values[1])
+                vsize = int(values[2]) if len(values) == 3 else 0
+            except ValueError:
+                # Skip header
+                if count == 0:
+                    continue
+                print(f'Invalid trace row: {row}', file=sys.stderr)
+                exit(1)
+
+            if last_timestamp is not None and timestamp < last_timestamp:
+                print('Trace must be sorted by timestamp', file=sys.stderr)
+                exit(1)
+
+            output_file.write(struct.pack(RECORD_FORMAT, timestamp, fee, vsize))
+            last_timestamp = timestamp
+            count += 1
+
+        output_file.seek(0)
+        output_file.write(struct.pack('<8sIIQ', TRACE_MAGIC, TRACE_VERSION, 0, count))
+
+
+if __name__ == '__main__':
+    main()
@@ -9,12 +9,14 @@
 #ifndef BLOCKPROPAGATIONDELAY_H
 #define BLOCKPROPAGATIONDELAY_H
 
-#include <initializer_list>
+#include <iterator>
+#include "../AliasTable.h"
 
 // Data from block propagated at 02.28.2022 from https://www.dsn.kastel.kit.edu/bitcoin/index.html
 
-const std::initializer_list<double>
-		blockPropDelayData{0.000154473, 0, 1.4043e-05, 1.4043e-05, 1.4043e-05, 5.61719e-05,
+// Weight of delay in milliseconds at the given index
+constexpr double
+		blockPropDelayData[]{0.000154473, 0, 1.4043e-05, 1.4043e-05, 1.4043e-05, 5.61719e-05,
 		                      1.4043e-05,
 		                      1.4043e-05, 4.21289e-05, 4.21289e-05, 5.61719e-05, 4.21289e-05,
 		                      2.80859e-05,
@@ -3404,4 +3406,7 @@ const std::initializer_list<double>
 		                      0, 0, 0, 0, 0, 0,
 		                      0, 0, 0, 0, 0, 0, 0, 0, 0};
 
+// Alias table over the data, built at compile time in ConfigParser.cpp
+extern const AliasTable<std::size(blockPropDelayData)> blockPropDelayTable;
+
 #endif //BLOCKPROPAGATIONDELAY_H